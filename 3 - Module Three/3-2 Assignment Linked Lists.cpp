@@ -32,6 +32,13 @@ struct Bid {
     }
 };
 
+// self-organizing strategies applied to a node when a search finds it
+enum class SearchMode {
+    STATIC,        // leave the list order untouched
+    MOVE_TO_FRONT, // move the found node to the head of the list
+    TRANSPOSE      // swap the found node with its predecessor
+};
+
 //============================================================================
 // Linked-List class definition
 //============================================================================
@@ -64,6 +71,13 @@ private:
     Node* tail;
     int size = 0;
 
+    // Self-organizing strategy applied to found nodes and the search statistics
+    SearchMode searchMode = SearchMode::STATIC;
+    unsigned long searchCount = 0;
+    unsigned long hitCount = 0;
+    unsigned long comparisonCount = 0;
+    unsigned long lastComparisons = 0;
+
 public:
     LinkedList();
     virtual ~LinkedList();
@@ -73,6 +87,12 @@ public:
     void Remove(string bidId);
     Bid Search(string bidId);
     int Size();
+    void SetSearchMode(SearchMode mode);
+    SearchMode GetSearchMode();
+    void PrintSearchStats();
+    void ResetSearchStats();
+    unsigned long LastComparisons();
+    double AverageComparisons();
 };
 
 /**
@@ -236,31 +256,78 @@ void LinkedList::Remove(string bidId) {
 /**
  * Search for the specified bidId
  *
+ * When a self-organizing search mode is enabled the found node is
+ * promoted toward the head so frequently requested bids are reached
+ * with fewer comparisons on later searches.
+ *
  * @param bidId The bid id to search for
  */
 Bid LinkedList::Search(string bidId) {
-    // Initializes a new pointer and sets it to the list's head
+    // Initializes the pointers used to walk the list and to relink the found node
+    Node* prevPrevNode = nullptr;
+    Node* prevNode = nullptr;
     Node* currNode = head;
+    // Initializes a local counter for the comparisons made by this search
+    unsigned long comparisons = 0;
 
-    // Checks if the head is not null and if the head's bid id value equals the passed in bid id
-    if (currNode != nullptr && currNode->bid.bidId == bidId) {
-        // Returns the associated bid
-        return currNode->bid;
-    }
+    // Records the search in the statistics
+    searchCount++;
 
     // Loops through the list until a null value is reached
     while (currNode != nullptr) {
+        // Counts the comparison against the current node
+        comparisons++;
+
         // Checks if the current node's bid id is equal to the passed in id
         if (currNode->bid.bidId == bidId) {
-            // Returns if the current bid
+            // Records the comparisons and the hit in the statistics
+            lastComparisons = comparisons;
+            comparisonCount += comparisons;
+            hitCount++;
+
+            // Checks if the node is not already at the head and the list is self-organizing
+            if (prevNode != nullptr && searchMode == SearchMode::MOVE_TO_FRONT) {
+                // Detaches the found node from its current position
+                prevNode->next = currNode->next;
+                // Checks if the found node was the tail, making its predecessor the new tail
+                if (tail == currNode) {
+                    tail = prevNode;
+                }
+                // Places the found node at the head of the list
+                currNode->next = head;
+                head = currNode;
+            }
+            else if (prevNode != nullptr && searchMode == SearchMode::TRANSPOSE) {
+                // Detaches the found node and places it in front of its predecessor
+                prevNode->next = currNode->next;
+                currNode->next = prevNode;
+                // Checks if the predecessor was the head, making the found node the new head
+                if (prevPrevNode == nullptr) {
+                    head = currNode;
+                }
+                else {
+                    prevPrevNode->next = currNode;
+                }
+                // Checks if the found node was the tail, making its predecessor the new tail
+                if (tail == currNode) {
+                    tail = prevNode;
+                }
+            }
+
+            // Returns the found bid
             return currNode->bid;
         }
-        else {
-            // Iterates through the list by moving to the next node
-            currNode = currNode->next;
-        }
+
+        // Iterates through the list by moving to the next node
+        prevPrevNode = prevNode;
+        prevNode = currNode;
+        currNode = currNode->next;
     }
 
+    // Records the comparisons of the unsuccessful search in the statistics
+    lastComparisons = comparisons;
+    comparisonCount += comparisons;
+
     // Initializes a new empty bid
     Bid emptyBid = Bid();
     // Returns the emptyBid if the bidId is not found
@@ -274,6 +341,76 @@ int LinkedList::Size() {
     return size;
 }
 
+/**
+ * Sets the self-organizing strategy used by Search
+ *
+ * @param mode The strategy to apply to found nodes
+ */
+void LinkedList::SetSearchMode(SearchMode mode) {
+    searchMode = mode;
+}
+
+/**
+ * Returns the self-organizing strategy used by Search
+ */
+SearchMode LinkedList::GetSearchMode() {
+    return searchMode;
+}
+
+/**
+ * Returns the number of comparisons made by the most recent search
+ */
+unsigned long LinkedList::LastComparisons() {
+    return lastComparisons;
+}
+
+/**
+ * Returns the average number of comparisons made per search
+ */
+double LinkedList::AverageComparisons() {
+    // Checks if no searches have been made to avoid dividing by zero
+    if (searchCount == 0) {
+        return 0.0;
+    }
+
+    return comparisonCount * 1.0 / searchCount;
+}
+
+/**
+ * Clears the search statistics, e.g. before replaying a query log
+ */
+void LinkedList::ResetSearchStats() {
+    searchCount = 0;
+    hitCount = 0;
+    comparisonCount = 0;
+    lastComparisons = 0;
+}
+
+/**
+ * Simple output of the search mode and statistics
+ */
+void LinkedList::PrintSearchStats() {
+    // Displays the name of the current search mode
+    cout << "Search mode: ";
+    switch (searchMode) {
+    case SearchMode::MOVE_TO_FRONT:
+        cout << "move-to-front" << endl;
+        break;
+    case SearchMode::TRANSPOSE:
+        cout << "transpose" << endl;
+        break;
+    default:
+        cout << "static" << endl;
+        break;
+    }
+
+    // Displays the collected statistics
+    cout << "Searches: " << searchCount << " (" << hitCount << " found, "
+        << searchCount - hitCount << " not found)" << endl;
+    cout << "Comparisons: " << comparisonCount << " total, "
+        << AverageComparisons() << " average per search" << endl;
+}
+
 //============================================================================
 // Static methods used for testing
 //============================================================================
@@ -399,6 +536,8 @@ int main(int argc, char* argv[]) {
         cout << "  3. Display All Bids" << endl;
         cout << "  4. Find Bid" << endl;
         cout << "  5. Remove Bid" << endl;
+        cout << "  6. Change Search Mode" << endl;
+        cout << "  7. Display Search Statistics" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -443,6 +582,8 @@ int main(int argc, char* argv[]) {
                 cout << "Bid Id " << bidKey << " not found." << endl;
             }
 
+            cout << "comparisons: " << bidList.LastComparisons() << endl;
+
             cout << "time: " << ticks << " clock ticks" << endl;
             cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
 
@@ -451,6 +592,29 @@ int main(int argc, char* argv[]) {
         case 5:
             bidList.Remove(bidKey);
 
+            break;
+
+        case 6:
+            // Cycles through the static, move-to-front and transpose search modes
+            if (bidList.GetSearchMode() == SearchMode::STATIC) {
+                bidList.SetSearchMode(SearchMode::MOVE_TO_FRONT);
+            }
+            else if (bidList.GetSearchMode() == SearchMode::MOVE_TO_FRONT) {
+                bidList.SetSearchMode(SearchMode::TRANSPOSE);
+            }
+            else {
+                bidList.SetSearchMode(SearchMode::STATIC);
+            }
+
+            // Starts a fresh set of statistics for the new mode
+            bidList.ResetSearchStats();
+            bidList.PrintSearchStats();
+
+            break;
+
+        case 7:
+            bidList.PrintSearchStats();
+
             break;
         case 9: 
             // breaks the switch statement if the exit value is entered
@@ -7,12 +7,49 @@
 //============================================================================
 
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
 #include <string> // atoi
+#include <thread>
 #include <time.h>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <io.h> // _commit, _fileno, _chsize_s
+#define fsync _commit
+#define fileno _fileno
+#define ftruncate _chsize_s
+#else
+#include <unistd.h> // fsync, ftruncate
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h> // SSE2 group probing
+#define FLAT_TABLE_SSE2 1
+#endif
+
+// hint the cache to start loading an address that will be read soon
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#elif defined(FLAT_TABLE_SSE2)
+#define PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define PREFETCH(address) ((void)(address))
+#endif
 
 #include "CSVparser.hpp"
+#include "../BloomFilter.hpp"
 
 using namespace std;
 
@@ -22,112 +59,2295 @@ using namespace std;
 
 const unsigned int DEFAULT_SIZE = 179;
 
+// load factor (bids per bucket) above which the chained table grows
+const double DEFAULT_MAX_LOAD_FACTOR = 1.0;
+
+// minimum old buckets migrated by each operation during an incremental rehash
+const unsigned int REHASH_BUCKETS_PER_OPERATION = 4;
+
+// number of independently locked sub-tables in a ConcurrentHashTable
+const unsigned int DEFAULT_SHARD_COUNT = 64;
+
+// number of keys SearchMany prefetches ahead of the key it is resolving
+const unsigned int PREFETCH_DISTANCE = 16;
+
+// number of logged operations written and synced together by a group commit
+const size_t DEFAULT_LOG_GROUP_SIZE = 256;
+
 // forward declarations
 double strToDouble(string str, char ch);
 
-// define a structure to hold bid information
-struct Bid {
-    string bidId; // unique identifier
-    string title;
-    string fund;
-    double amount;
-    Bid() {
-        amount = 0.0;
+// define a structure to hold bid information
+struct Bid {
+    string bidId; // unique identifier
+    string title;
+    string fund;
+    double amount;
+    Bid() {
+        amount = 0.0;
+    }
+};
+
+//============================================================================
+// Hash policies for string bid ids
+//============================================================================
+
+/**
+ * Default hash policy: 64-bit FNV-1a over the id's bytes with a final
+ * avalanche so short, sequential ids spread over every bucket.
+ * A seed can be folded into the starting state to vary the layout.
+ */
+struct StringHash {
+    uint64_t seed;
+
+    StringHash() {
+        seed = 0;
+    }
+
+    StringHash(uint64_t aSeed) {
+        seed = aSeed;
+    }
+
+    uint64_t operator()(const string& key) const {
+        uint64_t h = 14695981039346656037ULL ^ seed;
+        for (unsigned char c : key) {
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+
+        // Mixes the high bits down into the low bits used for the bucket index
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
+
+/**
+ * Identity policy for numeric ids: the id's integer value is its hash, so
+ * sequential ids land in sequential buckets of the prime-sized table.
+ * Ids containing anything other than digits fall back to StringHash
+ * rather than collapsing into a single bucket.
+ */
+struct NumericIdHash {
+    StringHash fallback;
+
+    uint64_t operator()(const string& key) const {
+        uint64_t value = 0;
+        for (unsigned char c : key) {
+            // Checks if the id is not purely numeric
+            if (c < '0' || c > '9') {
+                return fallback(key);
+            }
+            value = value * 10 + (c - '0');
+        }
+        return value;
+    }
+};
+
+/**
+ * Seeded policy for untrusted ids: SipHash-1-3 keyed with 128 random bits
+ * drawn when the table is created. Without the key an attacker cannot
+ * choose ids that share a bucket, so chains stay short.
+ */
+struct SeededStringHash {
+    uint64_t key0;
+    uint64_t key1;
+
+    // default constructor draws a fresh random key
+    SeededStringHash() {
+        random_device device;
+        key0 = (static_cast<uint64_t>(device()) << 32) | device();
+        key1 = (static_cast<uint64_t>(device()) << 32) | device();
+    }
+
+    // initialize with a fixed key, e.g. to reproduce a table layout
+    SeededStringHash(uint64_t aKey0, uint64_t aKey1) {
+        key0 = aKey0;
+        key1 = aKey1;
+    }
+
+    static uint64_t rotl(uint64_t x, int b) {
+        return (x << b) | (x >> (64 - b));
+    }
+
+    static void sipRound(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+        v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+        v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+    }
+
+    uint64_t operator()(const string& key) const {
+        uint64_t v0 = 0x736f6d6570736575ULL ^ key0;
+        uint64_t v1 = 0x646f72616e646f6dULL ^ key1;
+        uint64_t v2 = 0x6c7967656e657261ULL ^ key0;
+        uint64_t v3 = 0x7465646279746573ULL ^ key1;
+
+        // Compresses each full little-endian 8-byte block with one round
+        size_t length = key.size();
+        size_t blockEnd = length - (length % 8);
+        for (size_t i = 0; i < blockEnd; i += 8) {
+            uint64_t m = 0;
+            for (int b = 0; b < 8; b++) {
+                m |= static_cast<uint64_t>(static_cast<unsigned char>(key[i + b])) << (8 * b);
+            }
+            v3 ^= m;
+            sipRound(v0, v1, v2, v3);
+            v0 ^= m;
+        }
+
+        // Compresses the remaining bytes together with the length
+        uint64_t m = static_cast<uint64_t>(length & 0xff) << 56;
+        for (size_t i = blockEnd; i < length; i++) {
+            m |= static_cast<uint64_t>(static_cast<unsigned char>(key[i])) << (8 * (i - blockEnd));
+        }
+        v3 ^= m;
+        sipRound(v0, v1, v2, v3);
+        v0 ^= m;
+
+        // Finalizes with three rounds
+        v2 ^= 0xff;
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        sipRound(v0, v1, v2, v3);
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+};
+
+//============================================================================
+// Mutation Log class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement an append-only log of Insert and Remove operations.
+ *
+ * Records are buffered and written with a single write and fsync once
+ * a group of them has built up (group commit), or when Sync is called.
+ * Each record carries its length and a checksum so a record torn by a
+ * crash is detected on replay and cut off the end of the file, so records
+ * appended by later sessions follow the last intact record and are never
+ * hidden behind the damaged one. Values are stored in the
+ * machine's native byte order. A failed write or sync is reported and its
+ * records stay buffered, so the next Sync retries them.
+ *
+ * Record layout: uint32 payload length | uint32 checksum | payload, where
+ * the payload is the op byte followed by length-prefixed bidId, title and
+ * fund strings and the amount for an insert or replace, or just the bidId
+ * for a remove. An insert added a new id; a replace overwrote the bid of an
+ * id that was already stored, possibly one loaded from the CSV file.
+ */
+class MutationLog {
+
+public:
+    static const char OP_INSERT = 'I';
+    static const char OP_REPLACE = 'U';
+    static const char OP_REMOVE = 'R';
+
+private:
+    string path;
+    FILE* file = nullptr;
+    string buffer;
+    size_t pendingRecords = 0;
+    size_t groupSize = DEFAULT_LOG_GROUP_SIZE;
+
+    void open();
+    void appendRecord(const string& payload);
+    void appendBid(char op, const Bid& bid);
+    static void putString(string& out, const string& value);
+    static bool getString(const char*& cursor, const char* end, string& value);
+    static uint32_t checksum(const char* data, size_t length);
+    static bool writeRecord(FILE* out, const string& payload);
+    static void recoverCompaction(const string& logPath);
+    static void truncateLog(const string& logPath, size_t length);
+
+public:
+    MutationLog(const string& logPath);
+    MutationLog(const string& logPath, size_t groupSize);
+    virtual ~MutationLog();
+    void AppendInsert(const Bid& bid);
+    void AppendReplace(const Bid& bid);
+    void AppendRemove(const string& bidId);
+    bool Sync();
+    size_t Compact();
+
+    template <typename Visitor>
+    static size_t Replay(const string& logPath, Visitor visit);
+};
+
+// Definitions for the class constants, needed when they are bound to references
+const char MutationLog::OP_INSERT;
+const char MutationLog::OP_REPLACE;
+const char MutationLog::OP_REMOVE;
+
+/**
+ * Constructor, opens the log for appending
+ */
+MutationLog::MutationLog(const string& logPath) : MutationLog(logPath, DEFAULT_LOG_GROUP_SIZE) {
+}
+
+/**
+ * Constructor for specifying how many records make up a group commit
+ * Reads the log once before opening it, which settles an interrupted
+ * compaction and cuts off a torn tail so new records follow intact ones.
+ */
+MutationLog::MutationLog(const string& logPath, size_t groupSize) {
+    path = logPath;
+    this->groupSize = max<size_t>(groupSize, 1);
+    Replay(path, [](char, Bid&) {});
+    open();
+}
+
+/**
+ * Destructor, commits any buffered records
+ */
+MutationLog::~MutationLog() {
+    Sync();
+    if (file != nullptr) {
+        fclose(file);
+    }
+}
+
+/**
+ * Open the log file for appending
+ * The file is unbuffered since records are already grouped in buffer, so
+ * every byte fwrite accepts has reached the operating system.
+ */
+void MutationLog::open() {
+    file = fopen(path.c_str(), "ab");
+    if (file == nullptr) {
+        cerr << "Could not open mutation log " << path << endl;
+        return;
+    }
+    setvbuf(file, nullptr, _IONBF, 0);
+}
+
+/**
+ * Calculate a record's checksum (FNV-1a, 32-bit)
+ *
+ * @param data The payload bytes
+ * @param length The number of payload bytes
+ */
+uint32_t MutationLog::checksum(const char* data, size_t length) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/**
+ * Append a length-prefixed string to a payload
+ */
+void MutationLog::putString(string& out, const string& value) {
+    uint32_t length = static_cast<uint32_t>(value.size());
+    out.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.append(value);
+}
+
+/**
+ * Read a length-prefixed string from a payload
+ *
+ * @return False if the payload ends before the string does
+ */
+bool MutationLog::getString(const char*& cursor, const char* end, string& value) {
+    uint32_t length;
+    if (end - cursor < static_cast<ptrdiff_t>(sizeof(length))) {
+        return false;
+    }
+    memcpy(&length, cursor, sizeof(length));
+    cursor += sizeof(length);
+
+    if (static_cast<size_t>(end - cursor) < length) {
+        return false;
+    }
+    value.assign(cursor, length);
+    cursor += length;
+    return true;
+}
+
+/**
+ * Frame a payload with its length and checksum and write it to a file
+ *
+ * @return False if the record could not be written in full
+ */
+bool MutationLog::writeRecord(FILE* out, const string& payload) {
+    uint32_t header[2] = { static_cast<uint32_t>(payload.size()), checksum(payload.data(), payload.size()) };
+    return fwrite(header, sizeof(header), 1, out) == 1
+        && fwrite(payload.data(), 1, payload.size(), out) == payload.size();
+}
+
+/**
+ * Finish or discard a compaction interrupted by a crash
+ * The compacted file is only complete once it has been synced, and the old
+ * log is only gone after that point. So a leftover compacted file next to
+ * the log may be partial and is discarded. If the log itself is missing,
+ * the compacted file is complete and takes its place.
+ *
+ * @param logPath The path of the log file
+ */
+void MutationLog::recoverCompaction(const string& logPath) {
+    string compactPath = logPath + ".compact";
+    FILE* compacted = fopen(compactPath.c_str(), "rb");
+    if (compacted == nullptr) {
+        return;
+    }
+    fclose(compacted);
+
+    FILE* log = fopen(logPath.c_str(), "rb");
+    if (log != nullptr) {
+        fclose(log);
+        remove(compactPath.c_str());
+    }
+    else if (rename(compactPath.c_str(), logPath.c_str()) != 0) {
+        cerr << "Could not restore compacted mutation log " << compactPath << endl;
+    }
+}
+
+/**
+ * Frame a payload into the buffer, committing the group once it is full
+ */
+void MutationLog::appendRecord(const string& payload) {
+    uint32_t header[2] = { static_cast<uint32_t>(payload.size()), checksum(payload.data(), payload.size()) };
+    buffer.append(reinterpret_cast<const char*>(header), sizeof(header));
+    buffer.append(payload);
+
+    pendingRecords++;
+    if (pendingRecords >= groupSize) {
+        Sync();
+    }
+}
+
+/**
+ * Log a record carrying a whole bid
+ *
+ * @param op OP_INSERT or OP_REPLACE
+ * @param bid The bid being stored
+ */
+void MutationLog::appendBid(char op, const Bid& bid) {
+    string payload(1, op);
+    putString(payload, bid.bidId);
+    putString(payload, bid.title);
+    putString(payload, bid.fund);
+    payload.append(reinterpret_cast<const char*>(&bid.amount), sizeof(bid.amount));
+    appendRecord(payload);
+}
+
+/**
+ * Log the insertion of a bid whose id was not stored yet
+ *
+ * @param bid The bid being inserted
+ */
+void MutationLog::AppendInsert(const Bid& bid) {
+    appendBid(OP_INSERT, bid);
+}
+
+/**
+ * Log the overwrite of a bid whose id was already stored
+ *
+ * @param bid The bid replacing the stored one
+ */
+void MutationLog::AppendReplace(const Bid& bid) {
+    appendBid(OP_REPLACE, bid);
+}
+
+/**
+ * Log the removal of a bid
+ *
+ * @param bidId The id of the bid being removed
+ */
+void MutationLog::AppendRemove(const string& bidId) {
+    string payload(1, OP_REMOVE);
+    putString(payload, bidId);
+    appendRecord(payload);
+}
+
+/**
+ * Cut a log file back to the end of its last intact record
+ *
+ * @param logPath The path of the log file
+ * @param length The number of bytes to keep
+ */
+void MutationLog::truncateLog(const string& logPath, size_t length) {
+    FILE* log = fopen(logPath.c_str(), "r+b");
+    if (log == nullptr || ftruncate(fileno(log), length) != 0 || fsync(fileno(log)) != 0) {
+        cerr << "Could not remove the damaged end of mutation log " << logPath << endl;
+    }
+    if (log != nullptr) {
+        fclose(log);
+    }
+}
+
+/**
+ * Write every buffered record and wait until it is on disk
+ * On failure the bytes not yet written stay buffered for the next Sync.
+ *
+ * @return False if the records could not be written or synced
+ */
+bool MutationLog::Sync() {
+    if (buffer.empty()) {
+        return true;
+    }
+    if (file == nullptr) {
+        cerr << "Mutation log " << path << " is not open, " << pendingRecords << " records not saved" << endl;
+        return false;
+    }
+
+    // Drops only the bytes that were written, so a retry continues where this one stopped
+    size_t written = fwrite(buffer.data(), 1, buffer.size(), file);
+    buffer.erase(0, written);
+    if (!buffer.empty() || fflush(file) != 0 || fsync(fileno(file)) != 0) {
+        cerr << "Could not sync mutation log " << path << ", " << pendingRecords << " records not durable" << endl;
+        return false;
+    }
+
+    pendingRecords = 0;
+    return true;
+}
+
+/**
+ * Call visit(op, bid) for every intact record of a log file, in order
+ * The whole file is read with one call and parsed in place; replay stops
+ * at the first truncated or corrupt record, which is cut off the file along
+ * with everything after it. For a remove only bid.bidId is set.
+ *
+ * @param logPath The path of the log file
+ * @param visit The function applying each operation
+ * @return The number of records visited
+ */
+template <typename Visitor>
+size_t MutationLog::Replay(const string& logPath, Visitor visit) {
+    // Settles any compaction a crash interrupted before reading
+    recoverCompaction(logPath);
+
+    // Reads the whole log into memory, a missing log simply has no records
+    ifstream in(logPath, ios::binary);
+    if (!in.is_open()) {
+        return 0;
+    }
+    string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+
+    const char* cursor = contents.data();
+    const char* end = cursor + contents.size();
+    size_t replayed = 0;
+    Bid bid;
+
+    while (end - cursor >= 8) {
+        // Reads the record header and checks the payload is complete and intact
+        uint32_t header[2];
+        memcpy(header, cursor, sizeof(header));
+        const char* payload = cursor + sizeof(header);
+        if (static_cast<size_t>(end - payload) < header[0] || header[0] == 0
+                || checksum(payload, header[0]) != header[1]) {
+            break;
+        }
+
+        // Decodes the operation and its fields
+        const char* field = payload + 1;
+        const char* payloadEnd = payload + header[0];
+        char op = payload[0];
+        bool valid = getString(field, payloadEnd, bid.bidId);
+        if (valid && (op == OP_INSERT || op == OP_REPLACE)) {
+            valid = getString(field, payloadEnd, bid.title) && getString(field, payloadEnd, bid.fund)
+                && payloadEnd - field == sizeof(bid.amount);
+            if (valid) {
+                memcpy(&bid.amount, field, sizeof(bid.amount));
+            }
+        }
+        if (!valid || (op != OP_INSERT && op != OP_REPLACE && op != OP_REMOVE)) {
+            break;
+        }
+
+        visit(op, bid);
+        replayed++;
+        cursor = payloadEnd;
+    }
+
+    // Cuts off a torn or corrupt tail so later appends are not hidden behind it
+    if (cursor != end) {
+        cerr << "Mutation log " << logPath << " ends with " << (end - cursor) << " damaged bytes, removing them" << endl;
+        truncateLog(logPath, cursor - contents.data());
+    }
+
+    return replayed;
+}
+
+/**
+ * Rewrite the log without operations that cancel out
+ * A remove makes the replaces of the same id logged since its last insert
+ * or remove redundant, so they are dropped. If that insert created the id,
+ * the remove cancels it and both records are dropped; otherwise the id
+ * existed before the log, e.g. in the CSV file, and the remove is kept.
+ * All other records are kept in their original order. The new log is
+ * written beside the old one and renamed over it once it is on disk; if
+ * anything fails the old log is kept unchanged.
+ *
+ * @return The number of records in the compacted log, or 0 if the buffered
+ *         records could not be committed first
+ */
+size_t MutationLog::Compact() {
+    // Commits buffered records and closes the log while it is rewritten,
+    // leaving the log alone if they could not be committed
+    if (!Sync()) {
+        return 0;
+    }
+    if (file != nullptr) {
+        fclose(file);
+        file = nullptr;
+    }
+
+    // Reads every record, tracking per id the records that are still live
+    vector<pair<char, Bid>> records;
+    vector<bool> live;
+    unordered_map<string, vector<size_t>> liveById;
+    Replay(path, [&](char op, Bid& bid) {
+        vector<size_t>& idRecords = liveById[bid.bidId];
+
+        if (op == OP_REMOVE) {
+            // Drops the replaces the remove overrides
+            while (!idRecords.empty() && records[idRecords.back()].first == OP_REPLACE) {
+                live[idRecords.back()] = false;
+                idRecords.pop_back();
+            }
+
+            // Checks if this remove cancels the insert that created the id
+            if (!idRecords.empty() && records[idRecords.back()].first == OP_INSERT) {
+                live[idRecords.back()] = false;
+                idRecords.pop_back();
+                return;
+            }
+        }
+
+        idRecords.push_back(records.size());
+        records.push_back(make_pair(op, bid));
+        live.push_back(true);
+    });
+
+    // Writes the live records to a temporary file and syncs it
+    string compactPath = path + ".compact";
+    FILE* out = fopen(compactPath.c_str(), "wb");
+    if (out == nullptr) {
+        cerr << "Could not write compacted mutation log " << compactPath << endl;
+        open();
+        return records.size();
+    }
+
+    size_t kept = 0;
+    bool written = true;
+    for (size_t i = 0; i < records.size() && written; i++) {
+        if (!live[i]) {
+            continue;
+        }
+
+        const Bid& bid = records[i].second;
+        string payload(1, records[i].first);
+        putString(payload, bid.bidId);
+        if (records[i].first != OP_REMOVE) {
+            putString(payload, bid.title);
+            putString(payload, bid.fund);
+            payload.append(reinterpret_cast<const char*>(&bid.amount), sizeof(bid.amount));
+        }
+        written = writeRecord(out, payload);
+        kept++;
+    }
+    written = written && fflush(out) == 0 && fsync(fileno(out)) == 0;
+    written = fclose(out) == 0 && written;
+
+    // Keeps the old log if the compacted one did not reach the disk in full
+    if (!written) {
+        cerr << "Could not write compacted mutation log " << compactPath << endl;
+        remove(compactPath.c_str());
+        open();
+        return records.size();
+    }
+
+    // Replaces the old log with the compacted one and reopens it for appending;
+    // rename replaces the old file atomically on POSIX, while Windows needs it
+    // removed first and recoverCompaction covers a crash in between
+#ifdef _WIN32
+    remove(path.c_str());
+#endif
+    if (rename(compactPath.c_str(), path.c_str()) != 0) {
+        cerr << "Could not replace mutation log " << path << " with " << compactPath << endl;
+    }
+    open();
+    return kept;
+}
+
+// define a structure to hold a snapshot of a hash table's shape and search costs
+struct HashTableStats {
+    size_t buckets = 0;        // number of buckets
+    size_t usedBuckets = 0;    // buckets holding at least one bid
+    size_t bids = 0;           // number of bids stored
+    size_t maxChain = 0;       // longest chain
+    double loadFactor = 0.0;   // bids per bucket
+    vector<size_t> chainHistogram; // chainHistogram[n] = buckets holding n bids
+    unsigned long hits = 0;    // searches that found their bid
+    unsigned long misses = 0;  // searches that did not
+    unsigned long hitComparisons = 0;  // id comparisons made by hits
+    unsigned long missComparisons = 0; // id comparisons made by misses
+    unsigned long bloomAvoided = 0;    // misses answered by the Bloom filter alone
+};
+
+//============================================================================
+// Hash Table class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a hash table with chaining.
+ *
+ * HashPolicy maps a bid id string to a 64-bit hash, e.g. StringHash,
+ * NumericIdHash or SeededStringHash.
+ */
+template <typename HashPolicy = StringHash>
+class HashTable {
+
+private:
+    // Define structures to hold bids
+    struct Node {
+        Bid bid;
+        unsigned int key;
+        Node *next;
+
+        // default constructor
+        Node() {
+            key = UINT_MAX;
+            next = nullptr;
+        }
+
+        // initialize with a bid
+        Node(Bid aBid) : Node() {
+            bid = aBid;
+        }
+
+        // initialize with a bid and a key
+        Node(Bid aBid, unsigned int aKey) : Node(aBid) {
+            key = aKey;
+        }
+    };
+
+    vector<Node> nodes;
+
+    unsigned int tableSize = DEFAULT_SIZE;
+    // Smallest table size the table will shrink back to
+    unsigned int minTableSize = DEFAULT_SIZE;
+    // Number of bids currently stored
+    size_t size = 0;
+    // Grow above this load factor, shrink below a quarter of it
+    double maxLoadFactor = DEFAULT_MAX_LOAD_FACTOR;
+
+    // Buckets still being drained by an incremental rehash; buckets below
+    // migrateIndex have already been moved into nodes
+    vector<Node> oldNodes;
+    unsigned int oldTableSize = 0;
+    unsigned int migrateIndex = 0;
+    // Old buckets drained per operation, enough to finish before the next resize
+    unsigned int migrateStepBuckets = REHASH_BUCKETS_PER_OPERATION;
+    bool incrementalRehash = false;
+
+    // Hash policy applied to bid ids
+    HashPolicy hasher;
+
+    // Search cost counters, only updated while collectStats is set; atomic
+    // so a ConcurrentHashTable shard can count under its shared lock
+    bool collectStats = false;
+    atomic<unsigned long> hitCount{0};
+    atomic<unsigned long> missCount{0};
+    atomic<unsigned long> hitComparisons{0};
+    atomic<unsigned long> missComparisons{0};
+
+    // Secondary index from a fund to the ids of its bids, and from each id
+    // to its position in that list so removals are constant time
+    unordered_map<string, vector<string>> fundIndex;
+    unordered_map<string, size_t> fundPosition;
+
+    // Optional Bloom filter answering most misses without touching a bucket
+    bool useBloomFilter = false;
+    BloomFilter bloomFilter;
+    atomic<unsigned long> bloomAvoided{0};
+
+    // Optional log that records every Insert and successful Remove
+    MutationLog* mutationLog = nullptr;
+
+    unsigned int hash(const string& bidId);
+    Node* bucketFor(const string& bidId, unsigned int& nodeKey);
+    Bid* findInChain(Node* currNode, const string& bidId, bool countStats = true);
+    void addNode(Bid bid);
+    void clearChains(vector<Node>& buckets);
+    void rehash(unsigned int newSize);
+    void shrinkIfSparse();
+    void migrateStep();
+    void finishMigration();
+    void relinkNode(Bid& bid, Node* chainedNode);
+    void indexFund(const Bid& bid);
+    void unindexFund(const Bid& bid);
+    void rebuildBloomFilter(size_t count);
+    bool bloomRulesOut(const string& bidId);
+    bool eraseBid(const string& bidId, bool display);
+    static unsigned int nextPrime(unsigned int value);
+
+public:
+    /**
+     * Define an iterator over the bids of a single fund
+     * Each step resolves the next indexed id through the table, so a full
+     * pass costs time proportional to the number of bids in the fund.
+     * Iterators are invalidated by Insert and Remove.
+     */
+    class FundIterator {
+    private:
+        HashTable* table;
+        vector<string>::const_iterator position;
+
+    public:
+        FundIterator(HashTable* aTable, vector<string>::const_iterator aPosition) {
+            table = aTable;
+            position = aPosition;
+        }
+
+        const Bid& operator*() const {
+            // Resolves to an empty bid rather than null should the index ever name a missing id
+            static const Bid missing;
+            unsigned int nodeKey;
+            const Bid* found = table->findInChain(table->bucketFor(*position, nodeKey), *position, false);
+            return found != nullptr ? *found : missing;
+        }
+
+        const Bid* operator->() const {
+            return &(**this);
+        }
+
+        FundIterator& operator++() {
+            ++position;
+            return *this;
+        }
+
+        bool operator!=(const FundIterator& other) const {
+            return position != other.position;
+        }
+    };
+
+    // Define a begin/end pair so a fund's bids can be visited with range-for
+    struct FundRange {
+        FundIterator first;
+        FundIterator last;
+
+        FundIterator begin() const {
+            return first;
+        }
+
+        FundIterator end() const {
+            return last;
+        }
+
+        bool empty() const {
+            return !(first != last);
+        }
+    };
+
+    HashTable();
+    HashTable(unsigned int size);
+    HashTable(unsigned int size, HashPolicy aHasher);
+    virtual ~HashTable();
+    void Insert(Bid bid);
+    void PrintAll();
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    void SearchMany(const vector<string>& bidIds, vector<const Bid*>& results);
+    size_t Size();
+    void Reserve(size_t count);
+    void SetMaxLoadFactor(double loadFactor);
+    double LoadFactor();
+    void SetIncrementalRehash(bool enabled);
+    bool IsRehashing();
+    void SetCollectStats(bool enabled);
+    void ResetStats();
+    HashTableStats Stats();
+    void PrintStats();
+    void DumpStats(ostream& out);
+    FundRange BidsForFund(const string& fund);
+    size_t FundSize(const string& fund);
+    void EnableBloomFilter(double falsePositiveRate);
+    unsigned long BloomAvoidedProbes();
+    void AttachLog(MutationLog* log);
+    size_t ReplayLog(const string& logPath);
+};
+
+/**
+ * Default constructor
+ */
+template <typename HashPolicy>
+HashTable<HashPolicy>::HashTable() {   
+    // Resizes the nodes array to the current tableSize var
+    nodes.resize(tableSize);
+}
+
+/**
+ * Constructor for specifying size of the table
+ * Use to improve efficiency of hashing algorithm
+ * by reducing collisions without wasting memory.
+ */
+template <typename HashPolicy>
+HashTable<HashPolicy>::HashTable(unsigned int size) {
+    // Updates the tableSize var, keeping at least one bucket
+    this->tableSize = size > 0 ? size : 1;
+    // Uses the requested size as the floor when shrinking after removals
+    this->minTableSize = this->tableSize;
+    // Resizes the nodes array to the passed in size var
+    nodes.resize(this->tableSize);
+}
+
+
+/**
+ * Constructor for specifying the size of the table and the hash policy
+ * instance, e.g. a SeededStringHash with a fixed key.
+ */
+template <typename HashPolicy>
+HashTable<HashPolicy>::HashTable(unsigned int size, HashPolicy aHasher) : HashTable(size) {
+    hasher = aHasher;
+}
+
+/**
+ * Destructor
+ */
+template <typename HashPolicy>
+HashTable<HashPolicy>::~HashTable() {
+    // Frees the chained nodes hanging off each bucket, including any not yet migrated
+    clearChains(nodes);
+    clearChains(oldNodes);
+    // Removes all elements in the node starting from the beginning of the vector
+    nodes.clear();
+    oldNodes.clear();
+}
+
+/**
+ * Frees every chained node, leaving only the (now empty) bucket heads
+ *
+ * @param buckets The bucket array to clear
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::clearChains(vector<Node>& buckets) {
+    // Iterates through the bucket vector
+    for (unsigned int i = 0; i < buckets.size(); i++) {
+        // Starts at the first chained node after the bucket head
+        Node* currNode = buckets[i].next;
+
+        // Deletes each chained node in turn
+        while (currNode != nullptr) {
+            Node* nextNode = currNode->next;
+            delete currNode;
+            currNode = nextNode;
+        }
+
+        // Marks the bucket head as empty
+        buckets[i].next = nullptr;
+        buckets[i].key = UINT_MAX;
+    }
+}
+
+/**
+ * Returns the smallest prime greater than or equal to value
+ * Prime table sizes keep the modulo hash from clustering sequential ids.
+ *
+ * @param value The minimum table size
+ */
+template <typename HashPolicy>
+unsigned int HashTable<HashPolicy>::nextPrime(unsigned int value) {
+    // Starts at the first odd candidate
+    if (value <= 2) {
+        return 2;
+    }
+    if (value % 2 == 0) {
+        value++;
+    }
+
+    // Tests odd candidates by trial division until a prime is found
+    while (true) {
+        bool isPrime = true;
+        for (unsigned int divisor = 3; divisor <= value / divisor; divisor += 2) {
+            if (value % divisor == 0) {
+                isPrime = false;
+                break;
+            }
+        }
+
+        if (isPrime) {
+            return value;
+        }
+        value += 2;
+    }
+}
+
+/**
+ * Rebuild the table with a new number of buckets
+ * In incremental mode only the new bucket array is allocated here, and
+ * the bids are moved over a few buckets at a time by later operations.
+ *
+ * @param newSize The new number of buckets
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::rehash(unsigned int newSize) {
+    // Completes any migration still in progress so there are at most two arrays
+    finishMigration();
+
+    // Checks if the rehash should be spread over the following operations
+    if (incrementalRehash) {
+        // Keeps the current buckets as the array being drained
+        oldNodes.swap(nodes);
+        oldTableSize = tableSize;
+        migrateIndex = 0;
+
+        // Starts the new bucket array empty
+        tableSize = newSize;
+        nodes.assign(newSize, Node());
+
+        // Counts the inserts left before the table would grow again, and the
+        // removals left before it would shrink again when shrinking is possible
+        double operationsLeft = maxLoadFactor * tableSize - size - 1;
+        double removalsLeft = size - maxLoadFactor * tableSize / 4;
+        if (tableSize > minTableSize && removalsLeft > 0) {
+            operationsLeft = min(operationsLeft, removalsLeft);
+        }
+
+        // Drains enough buckets per operation to finish within that many operations
+        double bucketsPerOperation = ceil(oldTableSize / max(1.0, floor(operationsLeft)));
+        migrateStepBuckets = max(REHASH_BUCKETS_PER_OPERATION, static_cast<unsigned int>(bucketsPerOperation));
+        return;
+    }
+
+    // Initializes a local vector holding every bid currently in the table
+    vector<Bid> bids;
+    bids.reserve(size);
+
+    // Moves the bids out of each bucket and its chain
+    for (unsigned int i = 0; i < nodes.size(); i++) {
+        Node* currNode = &(nodes[i]);
+        if (currNode->key == UINT_MAX) {
+            continue;
+        }
+        while (currNode != nullptr) {
+            bids.push_back(std::move(currNode->bid));
+            currNode = currNode->next;
+        }
+    }
+
+    // Frees the old chains and replaces the buckets with the new size
+    clearChains(nodes);
+    tableSize = newSize;
+    nodes.assign(newSize, Node());
+
+    // Re-inserts every bid using the new table size
+    for (Bid& bid : bids) {
+        addNode(std::move(bid));
+    }
+}
+
+/**
+ * Move one bid into its bucket in the new array
+ * Reuses the chained node when one is given, so migration only
+ * allocates when a bucket head was occupied in both arrays.
+ *
+ * @param bid The bid to move, left empty afterwards
+ * @param chainedNode The old chained node holding the bid, or nullptr for a bucket head
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::relinkNode(Bid& bid, Node* chainedNode) {
+    unsigned int nodeKey = hash(bid.bidId);
+    Node* headNode = &(nodes[nodeKey]);
+
+    // Checks if the new bucket is empty, in which case the bid moves into its head
+    if (headNode->key == UINT_MAX) {
+        headNode->bid = std::move(bid);
+        headNode->key = nodeKey;
+        delete chainedNode;
+        return;
+    }
+
+    // Otherwise the bid is linked directly after the bucket head
+    if (chainedNode == nullptr) {
+        chainedNode = new Node(std::move(bid), nodeKey);
+    }
+    chainedNode->key = nodeKey;
+    chainedNode->next = headNode->next;
+    headNode->next = chainedNode;
+}
+
+/**
+ * Migrate a bounded number of old buckets into the new array
+ * Called at the start of every Insert, Search and Remove while an
+ * incremental rehash is in progress, keeping per-operation cost flat.
+ * The step size is set by rehash so the last old bucket is drained before
+ * enough inserts or removals accumulate to trigger another resize.
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::migrateStep() {
+    // Exits if no incremental rehash is in progress
+    if (oldNodes.empty()) {
+        return;
+    }
+
+    // Drains up to migrateStepBuckets old buckets
+    for (unsigned int moved = 0; moved < migrateStepBuckets && migrateIndex < oldTableSize; moved++) {
+        Node* headNode = &(oldNodes[migrateIndex]);
+
+        // Checks if the old bucket holds any bids
+        if (headNode->key != UINT_MAX) {
+            // Moves the chained nodes first, reusing their allocations
+            Node* currNode = headNode->next;
+            while (currNode != nullptr) {
+                Node* nextNode = currNode->next;
+                relinkNode(currNode->bid, currNode);
+                currNode = nextNode;
+            }
+
+            // Moves the bid stored inline in the bucket head
+            relinkNode(headNode->bid, nullptr);
+            headNode->next = nullptr;
+            headNode->key = UINT_MAX;
+        }
+
+        migrateIndex++;
+    }
+
+    // Releases the old array once every bucket has been drained
+    if (migrateIndex >= oldTableSize) {
+        vector<Node>().swap(oldNodes);
+        oldTableSize = 0;
+        migrateIndex = 0;
+    }
+}
+
+/**
+ * Migrate every remaining old bucket at once
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::finishMigration() {
+    while (!oldNodes.empty()) {
+        migrateStep();
+    }
+}
+
+/**
+ * Enable or disable incremental rehashing
+ * Disabling it completes any migration in progress.
+ *
+ * @param enabled True to spread rehashes over later operations
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::SetIncrementalRehash(bool enabled) {
+    incrementalRehash = enabled;
+
+    // Checks if a pending migration must be completed now
+    if (!enabled) {
+        finishMigration();
+    }
+}
+
+/**
+ * Returns true while an incremental rehash is still migrating buckets
+ */
+template <typename HashPolicy>
+bool HashTable<HashPolicy>::IsRehashing() {
+    return !oldNodes.empty();
+}
+
+/**
+ * Grow the table so it can hold count bids without exceeding the
+ * maximum load factor, e.g. before a load of known row count.
+ *
+ * @param count The number of bids the table should be able to hold
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::Reserve(size_t count) {
+    // Calculates the number of buckets needed for the requested count
+    double needed = count / maxLoadFactor;
+
+    // Grows the table only if it is currently too small
+    if (needed > tableSize) {
+        rehash(nextPrime(static_cast<unsigned int>(needed) + 1));
+    }
+
+    // Sizes the Bloom filter for the same count
+    if (useBloomFilter && count > bloomFilter.Capacity()) {
+        rebuildBloomFilter(count);
+    }
+}
+
+/**
+ * Turn on the Bloom filter front-end for Search, SearchMany and Remove
+ * The filter is sized for the current bids and grows with Reserve.
+ *
+ * @param falsePositiveRate The fraction of misses allowed to reach a bucket
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::EnableBloomFilter(double falsePositiveRate) {
+    useBloomFilter = true;
+    bloomFilter.Reset(max<size_t>(size, DEFAULT_SIZE), falsePositiveRate);
+    rebuildBloomFilter(max<size_t>(size, DEFAULT_SIZE));
+}
+
+/**
+ * Resize the Bloom filter and add every stored bid id to it again
+ * This also clears the stale bits left behind by removals.
+ *
+ * @param count The number of ids the filter should be sized for
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::rebuildBloomFilter(size_t count) {
+    bloomFilter.Reset(count, bloomFilter.FalsePositiveRate());
+
+    // Adds the id of every bid in both bucket arrays
+    for (unsigned int i = 0; i < nodes.size() + oldNodes.size(); i++) {
+        Node* currNode = i < nodes.size() ? &(nodes[i]) : &(oldNodes[i - nodes.size()]);
+        if (currNode->key == UINT_MAX) {
+            continue;
+        }
+        while (currNode != nullptr) {
+            bloomFilter.Add(currNode->bid.bidId);
+            currNode = currNode->next;
+        }
+    }
+}
+
+/**
+ * Returns true when the Bloom filter proves a bid id is not in the table
+ * Every such answer is counted as an avoided probe.
+ *
+ * @param bidId The bid id to test
+ */
+template <typename HashPolicy>
+bool HashTable<HashPolicy>::bloomRulesOut(const string& bidId) {
+    if (useBloomFilter && !bloomFilter.MayContain(bidId)) {
+        bloomAvoided.fetch_add(1, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Returns the number of lookups the Bloom filter answered without a probe
+ */
+template <typename HashPolicy>
+unsigned long HashTable<HashPolicy>::BloomAvoidedProbes() {
+    return bloomAvoided;
+}
+
+/**
+ * Set the load factor above which the table grows
+ * The table shrinks again when the load factor falls below a quarter of it.
+ *
+ * @param loadFactor The maximum number of bids per bucket
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::SetMaxLoadFactor(double loadFactor) {
+    // Ignores non-positive load factors
+    if (loadFactor <= 0.0) {
+        return;
+    }
+
+    // Completes any migration paced for the old thresholds
+    finishMigration();
+
+    maxLoadFactor = loadFactor;
+    // Grows the table right away if it is now over the threshold
+    Reserve(size);
+}
+
+/**
+ * Halve the table after mass removals
+ * Shrinks once the load factor drops below a quarter of the maximum so a
+ * grow immediately after a shrink cannot happen. A shrink is put off while a
+ * migration is still running, e.g. after Reserve grew the table far ahead of
+ * its contents, so a removal never has to finish a migration itself.
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::shrinkIfSparse() {
+    // Checks if the table is sparse, still above its minimum size and not migrating
+    if (tableSize > minTableSize && size < maxLoadFactor * tableSize / 4 && oldNodes.empty()) {
+        rehash(max(minTableSize, nextPrime(tableSize / 2)));
+    }
+}
+
+/**
+ * Returns the current number of bids per bucket
+ */
+template <typename HashPolicy>
+double HashTable<HashPolicy>::LoadFactor() {
+    return size * 1.0 / tableSize;
+}
+
+/**
+ * Calculate the bucket index of a given bid id.
+ *
+ * @param bidId The key to hash
+ * @return The calculated hash
+ */
+template <typename HashPolicy>
+unsigned int HashTable<HashPolicy>::hash(const string& bidId) {
+    // Reduces the policy's hash using the current tableSize value
+    return hasher(bidId) % this->tableSize;
+}
+
+/**
+ * Locate the bucket that holds, or would hold, the given bid id
+ * During an incremental rehash ids whose old bucket has not been
+ * migrated yet still live in the old array.
+ *
+ * @param bidId The bid id to locate
+ * @param nodeKey Set to the bucket's index within its array
+ * @return A pointer to the bucket's head node
+ */
+template <typename HashPolicy>
+typename HashTable<HashPolicy>::Node* HashTable<HashPolicy>::bucketFor(const string& bidId, unsigned int& nodeKey) {
+    // Calls the hash policy once for both the old and the new bucket array
+    uint64_t hashValue = hasher(bidId);
+
+    // Checks if the id's bucket in the old array has not been migrated yet
+    if (!oldNodes.empty()) {
+        unsigned int oldKey = hashValue % oldTableSize;
+        if (oldKey >= migrateIndex) {
+            nodeKey = oldKey;
+            return &(oldNodes[oldKey]);
+        }
+    }
+
+    nodeKey = hashValue % tableSize;
+    return &(nodes[nodeKey]);
+}
+
+/**
+ * Insert a bid, replacing the bid already stored under the same id
+ * Grows the table first when the insert would exceed the maximum load factor.
+ *
+ * @param bid The bid to insert
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::Insert(Bid bid) {
+    // Moves a few buckets along if an incremental rehash is in progress
+    migrateStep();
+
+    // Checks if the id is already stored, skipping the chain walk when the Bloom filter rules it out
+    if (!useBloomFilter || bloomFilter.MayContain(bid.bidId)) {
+        unsigned int nodeKey;
+        Bid* existing = findInChain(bucketFor(bid.bidId, nodeKey), bid.bidId, false);
+        if (existing != nullptr) {
+            // Moves the id to its new fund, which may be the same one
+            unindexFund(*existing);
+            indexFund(bid);
+            if (mutationLog != nullptr) {
+                mutationLog->AppendReplace(bid);
+            }
+
+            // Updates the bid in place without changing the size
+            *existing = std::move(bid);
+            return;
+        }
+    }
+
+    // Checks if the new bid would push the table over its maximum load factor
+    if ((size + 1) > maxLoadFactor * tableSize) {
+        // Roughly doubles the number of buckets, keeping the size prime
+        rehash(nextPrime(tableSize * 2 + 1));
+    }
+
+    // Records the bid under its fund before the bid is moved into the table
+    indexFund(bid);
+
+    // Records the id in the Bloom filter, doubling the filter once it is overfull
+    if (useBloomFilter) {
+        if (bloomFilter.IsOverCapacity()) {
+            rebuildBloomFilter(bloomFilter.Capacity() * 2);
+        }
+        bloomFilter.Add(bid.bidId);
+    }
+
+    // Records the insert in the attached mutation log before the bid is moved
+    if (mutationLog != nullptr) {
+        mutationLog->AppendInsert(bid);
+    }
+
+    // Links the bid into its bucket and counts it
+    addNode(bid);
+    size++;
+}
+
+/**
+ * Add a bid's id to the list of its fund in the secondary index
+ *
+ * @param bid The bid being inserted
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::indexFund(const Bid& bid) {
+    vector<string>& fundIds = fundIndex[bid.fund];
+    fundPosition[bid.bidId] = fundIds.size();
+    fundIds.push_back(bid.bidId);
+}
+
+/**
+ * Remove a bid's id from the list of its fund in the secondary index
+ * The last id of the list is moved into the freed position.
+ *
+ * @param bid The bid being removed
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::unindexFund(const Bid& bid) {
+    auto fundIt = fundIndex.find(bid.fund);
+    auto positionIt = fundPosition.find(bid.bidId);
+
+    // Checks if the bid is not indexed under its fund
+    if (fundIt == fundIndex.end() || positionIt == fundPosition.end()) {
+        return;
+    }
+
+    vector<string>& fundIds = fundIt->second;
+    size_t position = positionIt->second;
+    if (position >= fundIds.size() || fundIds[position] != bid.bidId) {
+        return;
+    }
+
+    // Moves the last id into the removed id's position and drops the last entry
+    if (position != fundIds.size() - 1) {
+        fundIds[position] = std::move(fundIds.back());
+        fundPosition[fundIds[position]] = position;
+    }
+    fundIds.pop_back();
+    fundPosition.erase(positionIt);
+
+    // Drops funds that no longer hold any bids
+    if (fundIds.empty()) {
+        fundIndex.erase(fundIt);
+    }
+}
+
+/**
+ * Returns the bids of a fund, visited without scanning the table
+ *
+ * @param fund The fund to look up
+ */
+template <typename HashPolicy>
+typename HashTable<HashPolicy>::FundRange HashTable<HashPolicy>::BidsForFund(const string& fund) {
+    // Finishes any migration so the returned range cannot trigger one while resolving
+    finishMigration();
+
+    // Returns an empty range for unknown funds
+    static const vector<string> noIds;
+    auto fundIt = fundIndex.find(fund);
+    const vector<string>& fundIds = fundIt == fundIndex.end() ? noIds : fundIt->second;
+
+    FundRange range = { FundIterator(this, fundIds.begin()), FundIterator(this, fundIds.end()) };
+    return range;
+}
+
+/**
+ * Returns the number of bids in a fund
+ *
+ * @param fund The fund to look up
+ */
+template <typename HashPolicy>
+size_t HashTable<HashPolicy>::FundSize(const string& fund) {
+    auto fundIt = fundIndex.find(fund);
+    return fundIt == fundIndex.end() ? 0 : fundIt->second.size();
+}
+
+/**
+ * Link a bid into its bucket without checking the load factor
+ *
+ * @param bid The bid to link into the table
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::addNode(Bid bid) {
+    // Points to the bucket associated with the bid's id
+    unsigned int nodeKey;
+    Node* currNode = bucketFor(bid.bidId, nodeKey);
+
+    // Checks if the currNode is pointing to a null value
+    if (currNode == nullptr) {
+        // Point to a new Node
+        currNode = new Node(bid, nodeKey);
+    }
+    // Checks if the node is empty after a removal based on its key value
+    else if (currNode->key == UINT_MAX) {
+        // Set's currNode's bid and key property to their new values
+        currNode->bid = bid;
+        currNode->key = nodeKey;
+    }
+    else {
+        // Iterates through the singularly linked list until an null pointer is reached
+        while (currNode->next != nullptr) {
+            // Moves to the next element in the singularly linked list
+            currNode = currNode->next;
+        }
+
+        // Points the last element's next pointer to a new Node instantiated with the passed in bid and calculated key value
+        currNode->next = new Node(bid, nodeKey);
+    }
+}
+
+/**
+ * Print all bids
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::PrintAll() {
+    // Iterates through the nodes vector, followed by any buckets not yet migrated
+    for (unsigned int i = 0; i < nodes.size() + oldNodes.size(); i++) {
+        // Points to the Node located at the nodes vector's index
+        Node* currNode = i < nodes.size() ? &(nodes[i]) : &(oldNodes[i - nodes.size()]);
+
+        // Checks that the node is not empty
+        if (currNode != nullptr && currNode->key != UINT_MAX) {
+            // Loops through the singularly linked list until a null pointer is reached
+            while (currNode != nullptr) {
+                // Sets the node's bid to a local var
+                Bid bid = currNode->bid;
+                // Prints the information associated with the bid object to the console
+                cout << currNode->key << " | " << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+                    << bid.fund << endl;
+                // Points to the next element in the singularly linked list
+                currNode = currNode->next;
+            }
+        }
+    }
+}
+
+/**
+ * Remove a bid
+ * Successful removals are recorded in the attached mutation log, if any.
+ *
+ * @param bidId The bid id to search for
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::Remove(string bidId) {
+    // Checks if the bid was removed and a log should record it
+    if (eraseBid(bidId, true) && mutationLog != nullptr) {
+        mutationLog->AppendRemove(bidId);
+    }
+}
+
+/**
+ * Unlink and free the first bid with the given id
+ *
+ * @param bidId The bid id to search for
+ * @param display True to print the removed bid or a not-found message
+ * @return True if a bid was removed
+ */
+template <typename HashPolicy>
+bool HashTable<HashPolicy>::eraseBid(const string& bidId, bool display) {
+    // Moves a few buckets along if an incremental rehash is in progress
+    migrateStep();
+
+    // Checks if the Bloom filter proves the bid is not in the table
+    if (bloomRulesOut(bidId)) {
+        if (display) {
+            cout << "Associated node not found!" << endl;
+        }
+        return false;
+    }
+
+    // Initializes a pointer and points to the bucket associated with the bid's id
+    unsigned int nodeKey;
+    Node* currNode = bucketFor(bidId, nodeKey);
+
+    // Checks if the pointer is not pointing to a null value and is not empty from deletion node
+    if (currNode != nullptr && currNode->key != UINT_MAX) {
+        // Checks if the bucket's head node is the node to be deleted
+        if (currNode->bid.bidId == bidId) {
+            // Displays the soon to be removed bid's details to the screen
+            if (display) {
+                cout << currNode->key << " | " << currNode->bid.bidId << ": " << currNode->bid.title << " | "
+                    << currNode->bid.amount << " | " << currNode->bid.fund << endl;
+            }
+
+            // Drops the bid from the fund index
+            unindexFund(currNode->bid);
+
+            // Checks if the head node is the only element in the singularly linked list
+            if (currNode->next == nullptr) {
+                // Set's the current node's key to UINT_MAX indicating it is empty from deletion
+                currNode->key = UINT_MAX;
+                currNode->bid = Bid();
+            }
+            else {
+                // Moves the second node's data into the head node and unlinks the second node
+                Node* sucNode = currNode->next;
+                currNode->bid = std::move(sucNode->bid);
+                currNode->key = sucNode->key;
+                currNode->next = sucNode->next;
+                delete sucNode;
+            }
+
+            // Displays a message indicating that the bid was removed
+            if (display) {
+                cout << "Removed Bid" << endl;
+            }
+            // Decrements the size and shrinks the table if it became sparse
+            size--;
+            shrinkIfSparse();
+            // Exits the function
+            return true;
+        }
+        else {
+            // Initialize a new prevNode pointer to point to the previous node in the singly linked list
+            Node* prevNode = currNode;
+            // Iterates the currNode to the next node in the singly linked list
+            currNode = currNode->next;
+
+            // Loops through the singularly linked list until the current node's pointer is null
+            while (currNode != nullptr) {
+                // Checks if the currNode's bidId is equal to the passed in bidId
+                if (currNode->bid.bidId == bidId) {
+                    // Displays the soon to be removed bid's details to the screen
+                    if (display) {
+                        Bid& bid = currNode->bid;
+                        cout << currNode->key << " | " << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+                            << bid.fund << endl;
+                    }
+                    // Drops the bid from the fund index
+                    unindexFund(currNode->bid);
+                    // Points the prevNode's next pointer to the currNode's next pointer
+                    prevNode->next = currNode->next;
+                    // Removes the currNode from the singly linked list
+                    delete currNode;
+                    // Displays a message indicating that the bid was removed
+                    if (display) {
+                        cout << "Removed Bid" << endl;
+                    }
+                    // Decrements the size and shrinks the table if it became sparse
+                    size--;
+                    shrinkIfSparse();
+                    // Exits the function
+                    return true;
+                }
+
+                prevNode = currNode;
+                currNode = currNode->next;
+            }
+        }
+    }
+
+    // Displays a message indicating the node was not found
+    if (display) {
+        cout << "Associated node not found!" << endl;
+    }
+    return false;
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+template <typename HashPolicy>
+Bid HashTable<HashPolicy>::Search(string bidId) {
+    // Initializes an local bid with an empty bid
+    Bid bid = Bid();
+
+    // Moves a few buckets along if an incremental rehash is in progress
+    migrateStep();
+
+    // Returns the empty bid right away if the Bloom filter proves the bid is not in the table
+    if (bloomRulesOut(bidId)) {
+        return bid;
+    }
+
+    // Initializes a pointer and points to the bucket associated with the bid's id
+    unsigned int nodeKey;
+    Node* currNode = bucketFor(bidId, nodeKey);
+
+    // Walks the bucket's chain for the bid
+    const Bid* found = findInChain(currNode, bidId);
+    if (found != nullptr) {
+        // Returns the node's bid
+        return *found;
+    }
+
+    // Returns the empty bid if the associated bid is not found.
+    return bid;
+}
+
+/**
+ * Search for a batch of bid ids
+ * All buckets are located first and each is prefetched PREFETCH_DISTANCE
+ * keys before its chain is walked, so the cache misses of many lookups
+ * overlap instead of being paid one after another.
+ *
+ * @param bidIds The bid ids to search for
+ * @param results Set to one pointer per id, nullptr when the id is not found;
+ *                the pointers stay valid until the table is next modified
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::SearchMany(const vector<string>& bidIds, vector<const Bid*>& results) {
+    // Moves a few buckets along once for the whole batch
+    migrateStep();
+
+    // Hashes every id up front; this only computes addresses and touches no buckets,
+    // except that ids ruled out by the Bloom filter get no bucket at all
+    vector<Node*> buckets(bidIds.size());
+    for (size_t i = 0; i < bidIds.size(); i++) {
+        unsigned int nodeKey;
+        buckets[i] = bloomRulesOut(bidIds[i]) ? nullptr : bucketFor(bidIds[i], nodeKey);
+    }
+
+    // Prefetches the bucket heads of the first window of keys
+    for (size_t i = 0; i < bidIds.size() && i < PREFETCH_DISTANCE; i++) {
+        if (buckets[i] != nullptr) {
+            PREFETCH(buckets[i]);
+        }
+    }
+
+    // Resolves each id while keeping later buckets in flight: the bucket head
+    // PREFETCH_DISTANCE keys ahead, and the first chained node of the key half
+    // way there, whose head has had time to arrive
+    results.assign(bidIds.size(), nullptr);
+    for (size_t i = 0; i < bidIds.size(); i++) {
+        if (i + PREFETCH_DISTANCE < bidIds.size() && buckets[i + PREFETCH_DISTANCE] != nullptr) {
+            PREFETCH(buckets[i + PREFETCH_DISTANCE]);
+        }
+        Node* halfway = i + PREFETCH_DISTANCE / 2 < bidIds.size() ? buckets[i + PREFETCH_DISTANCE / 2] : nullptr;
+        if (halfway != nullptr && halfway->next != nullptr) {
+            PREFETCH(halfway->next);
+        }
+        if (buckets[i] != nullptr) {
+            results[i] = findInChain(buckets[i], bidIds[i]);
+        }
+    }
+}
+
+/**
+ * Walk a bucket's chain looking for a bid id, counting the comparisons
+ *
+ * @param currNode The bucket's head node
+ * @param bidId The bid id to search for
+ * @param countStats False for internal lookups that should not skew the statistics
+ * @return A pointer to the stored bid, or nullptr if the id is not in the chain
+ */
+template <typename HashPolicy>
+Bid* HashTable<HashPolicy>::findInChain(Node* currNode, const string& bidId, bool countStats) {
+    // Initializes a local counter for the id comparisons made by this search
+    unsigned long comparisons = 0;
+
+    // Checks if the currNode is not pointing to a null value and is not empty from deletion node
+    if (currNode != nullptr && currNode->key != UINT_MAX) {
+        // Loops through the singularly linked list until a null value is reached
+        while (currNode != nullptr) {
+            // Checks if the currNode's bidId is equal to the passed in bidId
+            comparisons++;
+            if (currNode->bid.bidId == bidId) {
+                // Records the hit in the statistics
+                if (collectStats && countStats) {
+                    hitCount.fetch_add(1, memory_order_relaxed);
+                    hitComparisons.fetch_add(comparisons, memory_order_relaxed);
+                }
+                // Returns the node's bid
+                return &(currNode->bid);
+            }
+
+            // Points to the next element in the singularly linked list
+            currNode = currNode->next;
+        }
+    }
+
+    // Records the miss in the statistics
+    if (collectStats && countStats) {
+        missCount.fetch_add(1, memory_order_relaxed);
+        missComparisons.fetch_add(comparisons, memory_order_relaxed);
+    }
+
+    // Returns null if the associated bid is not found
+    return nullptr;
+}
+
+/**
+ * Returns the number of bids in the table
+ */
+template <typename HashPolicy>
+size_t HashTable<HashPolicy>::Size() {
+    return size;
+}
+
+/**
+ * Enable or disable counting the comparisons made by Search
+ *
+ * @param enabled True to record hits, misses and their comparisons
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::SetCollectStats(bool enabled) {
+    collectStats = enabled;
+}
+
+/**
+ * Clear the search counters, e.g. before replaying a day's lookups
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::ResetStats() {
+    hitCount = 0;
+    missCount = 0;
+    hitComparisons = 0;
+    missComparisons = 0;
+    bloomAvoided = 0;
+}
+
+/**
+ * Collect the table's current shape and search counters
+ *
+ * @return A snapshot of the bucket occupancy, chain lengths and search costs
+ */
+template <typename HashPolicy>
+HashTableStats HashTable<HashPolicy>::Stats() {
+    HashTableStats stats;
+    stats.buckets = nodes.size() + oldNodes.size();
+    stats.bids = size;
+    stats.loadFactor = LoadFactor();
+
+    // Measures the chain of every bucket, including any not yet migrated
+    for (unsigned int i = 0; i < nodes.size() + oldNodes.size(); i++) {
+        Node* currNode = i < nodes.size() ? &(nodes[i]) : &(oldNodes[i - nodes.size()]);
+
+        // Counts the bids in the bucket's chain
+        size_t chainLength = 0;
+        if (currNode->key != UINT_MAX) {
+            while (currNode != nullptr) {
+                chainLength++;
+                currNode = currNode->next;
+            }
+        }
+
+        // Records the chain length in the histogram
+        if (chainLength >= stats.chainHistogram.size()) {
+            stats.chainHistogram.resize(chainLength + 1, 0);
+        }
+        stats.chainHistogram[chainLength]++;
+
+        if (chainLength > 0) {
+            stats.usedBuckets++;
+        }
+        stats.maxChain = max(stats.maxChain, chainLength);
+    }
+
+    stats.hits = hitCount;
+    stats.misses = missCount;
+    stats.hitComparisons = hitComparisons;
+    stats.missComparisons = missComparisons;
+    stats.bloomAvoided = bloomAvoided;
+    return stats;
+}
+
+/**
+ * Display the table's statistics to the console
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::PrintStats() {
+    HashTableStats stats = Stats();
+
+    cout << "Buckets: " << stats.buckets << " (" << stats.usedBuckets << " used)" << endl;
+    cout << "Bids: " << stats.bids << ", load factor: " << stats.loadFactor << endl;
+    cout << "Longest chain: " << stats.maxChain << endl;
+
+    // Displays the histogram of chain lengths
+    cout << "Chain length | buckets" << endl;
+    for (size_t length = 0; length < stats.chainHistogram.size(); length++) {
+        if (stats.chainHistogram[length] != 0) {
+            cout << "  " << length << " | " << stats.chainHistogram[length] << endl;
+        }
+    }
+
+    // Displays the average comparisons, avoiding a divide by zero
+    cout << "Searches: " << stats.hits << " hits, " << stats.misses << " misses" << endl;
+    cout << "Average comparisons per hit: "
+        << (stats.hits == 0 ? 0.0 : stats.hitComparisons * 1.0 / stats.hits) << endl;
+    cout << "Average comparisons per miss: "
+        << (stats.misses == 0 ? 0.0 : stats.missComparisons * 1.0 / stats.misses) << endl;
+    cout << "Probes avoided by the Bloom filter: " << stats.bloomAvoided << endl;
+}
+
+/**
+ * Write the table's statistics as a single JSON object
+ *
+ * @param out The stream to write to, e.g. a file for later analysis
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::DumpStats(ostream& out) {
+    HashTableStats stats = Stats();
+
+    out << "{\"buckets\":" << stats.buckets
+        << ",\"usedBuckets\":" << stats.usedBuckets
+        << ",\"bids\":" << stats.bids
+        << ",\"loadFactor\":" << stats.loadFactor
+        << ",\"maxChain\":" << stats.maxChain
+        << ",\"chainHistogram\":[";
+    for (size_t length = 0; length < stats.chainHistogram.size(); length++) {
+        out << (length == 0 ? "" : ",") << stats.chainHistogram[length];
+    }
+    out << "],\"hits\":" << stats.hits
+        << ",\"misses\":" << stats.misses
+        << ",\"hitComparisons\":" << stats.hitComparisons
+        << ",\"missComparisons\":" << stats.missComparisons
+        << ",\"bloomAvoided\":" << stats.bloomAvoided
+        << "}" << endl;
+}
+
+/**
+ * Record every later Insert and successful Remove in a mutation log
+ *
+ * @param log The log to append to, or nullptr to stop logging
+ */
+template <typename HashPolicy>
+void HashTable<HashPolicy>::AttachLog(MutationLog* log) {
+    mutationLog = log;
+}
+
+/**
+ * Apply a mutation log's operations on top of the current contents
+ * Replayed operations are not logged again.
+ *
+ * @param logPath The path of the log file
+ * @return The number of operations replayed
+ */
+template <typename HashPolicy>
+size_t HashTable<HashPolicy>::ReplayLog(const string& logPath) {
+    // Detaches the log while replaying so the operations are not appended twice
+    MutationLog* attachedLog = mutationLog;
+    mutationLog = nullptr;
+
+    size_t replayed = MutationLog::Replay(logPath, [this](char op, Bid& bid) {
+        if (op != MutationLog::OP_REMOVE) {
+            Insert(std::move(bid));
+        }
+        else {
+            eraseBid(bid.bidId, false);
+        }
+    });
+
+    mutationLog = attachedLog;
+    return replayed;
+}
+
+//============================================================================
+// Open-Addressing Hash Table class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement an open-addressing hash table.
+ *
+ * Bids are stored inline in a flat slot array. A separate array of
+ * one-byte control values records whether each slot is empty, deleted
+ * or full, and for full slots keeps 7 bits of the key's hash. Lookups
+ * compare a whole group of 16 control bytes at once (SSE2 when
+ * available) so only slots whose hash bits match are ever touched,
+ * and a lookup normally costs a single cache miss on the slot array.
+ */
+class FlatHashTable {
+
+private:
+    // Number of slots inspected by a single probe
+    static const size_t GROUP_SIZE = 16;
+
+    // Control byte values, full slots hold the 7 high hash bits (0..127);
+    // the low bits pick the probe group
+    static const int8_t CTRL_EMPTY = -128;
+    static const int8_t CTRL_DELETED = -2;
+
+    vector<int8_t> ctrl;
+    vector<Bid> slots;
+
+    size_t capacity = 0;
+    size_t size = 0;
+    size_t deleted = 0;
+
+    uint64_t hash(const string& bidId);
+    uint32_t matchGroup(size_t group, int8_t value);
+    static size_t firstMatch(uint32_t mask);
+    size_t findSlot(const string& bidId);
+    void rehash(size_t newCapacity);
+
+public:
+    FlatHashTable();
+    FlatHashTable(size_t size);
+    virtual ~FlatHashTable();
+    void Insert(Bid bid);
+    void PrintAll();
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    size_t Size();
+    void Reserve(size_t count);
+};
+
+// Definitions for the class constants, needed when they are bound to references
+const size_t FlatHashTable::GROUP_SIZE;
+const int8_t FlatHashTable::CTRL_EMPTY;
+const int8_t FlatHashTable::CTRL_DELETED;
+
+/**
+ * Default constructor
+ */
+FlatHashTable::FlatHashTable() : FlatHashTable(DEFAULT_SIZE) {
+}
+
+/**
+ * Constructor for specifying the expected number of bids
+ * The slot count is rounded up to a power of two number of groups
+ * large enough to hold that many bids below the maximum load factor.
+ */
+FlatHashTable::FlatHashTable(size_t size) {
+    // Starts with a single group and doubles until the bids fit at 7/8 load
+    size_t newCapacity = GROUP_SIZE;
+    while (newCapacity * 7 / 8 < size) {
+        newCapacity *= 2;
+    }
+
+    rehash(newCapacity);
+}
+
+/**
+ * Destructor
+ */
+FlatHashTable::~FlatHashTable() {
+    // The control bytes and slots are released with their vectors
+}
+
+/**
+ * Calculate the 64-bit hash value of a bid id (FNV-1a with a final mix)
+ * The low bits choose the starting group and the top 7 bits are stored
+ * in the control byte.
+ *
+ * @param bidId The key to hash
+ * @return The calculated hash
+ */
+uint64_t FlatHashTable::hash(const string& bidId) {
+    return StringHash()(bidId);
+}
+
+/**
+ * Compare all control bytes of a group against a value
+ *
+ * @param group Index of the first slot of the group
+ * @param value The control byte to look for
+ * @return A bit mask with bit i set when slot group + i matches
+ */
+uint32_t FlatHashTable::matchGroup(size_t group, int8_t value) {
+#ifdef FLAT_TABLE_SSE2
+    // Loads the 16 control bytes and compares them in a single instruction
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&ctrl[group]));
+    __m128i match = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(value));
+    return static_cast<uint32_t>(_mm_movemask_epi8(match));
+#else
+    // Portable fallback comparing the control bytes one at a time
+    uint32_t mask = 0;
+    for (size_t i = 0; i < GROUP_SIZE; i++) {
+        if (ctrl[group + i] == value) {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+/**
+ * Returns the position of the lowest set bit of a non-zero group mask
+ *
+ * @param mask A mask returned by matchGroup
+ */
+size_t FlatHashTable::firstMatch(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    size_t index = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Locate the slot holding the given bid id
+ *
+ * @param bidId The bid id to search for
+ * @return The slot index, or capacity if the bid id is not in the table
+ */
+size_t FlatHashTable::findSlot(const string& bidId) {
+    uint64_t h = hash(bidId);
+    int8_t tag = static_cast<int8_t>(h >> 57);
+    size_t numGroups = capacity / GROUP_SIZE;
+    size_t group = (h & (numGroups - 1)) * GROUP_SIZE;
+
+    // Probes groups in triangular order, which visits every group once
+    for (size_t step = 1; step <= numGroups; step++) {
+        // Only slots whose stored hash bits match are compared by id
+        uint32_t candidates = matchGroup(group, tag);
+        while (candidates != 0) {
+            size_t index = group + firstMatch(candidates);
+            if (slots[index].bidId == bidId) {
+                return index;
+            }
+            candidates &= candidates - 1;
+        }
+
+        // An empty slot ends the probe sequence since inserts never skip one
+        if (matchGroup(group, CTRL_EMPTY) != 0) {
+            break;
+        }
+
+        group = (group + step * GROUP_SIZE) & (capacity - 1);
+    }
+
+    return capacity;
+}
+
+/**
+ * Move every bid into a fresh slot array of the given capacity
+ * Deleted markers are dropped in the process.
+ *
+ * @param newCapacity Number of slots, a power of two multiple of the group size
+ */
+void FlatHashTable::rehash(size_t newCapacity) {
+    // Swaps the current arrays out so they can be re-inserted
+    vector<int8_t> oldCtrl(newCapacity, CTRL_EMPTY);
+    vector<Bid> oldSlots(newCapacity);
+    oldCtrl.swap(ctrl);
+    oldSlots.swap(slots);
+
+    capacity = newCapacity;
+    size = 0;
+    deleted = 0;
+
+    // Re-inserts all full slots from the old arrays
+    for (size_t i = 0; i < oldCtrl.size(); i++) {
+        if (oldCtrl[i] >= 0) {
+            Insert(std::move(oldSlots[i]));
+        }
+    }
+}
+
+/**
+ * Insert a bid, replacing any bid already stored with the same id
+ *
+ * @param bid The bid to insert
+ */
+void FlatHashTable::Insert(Bid bid) {
+    // Checks if the bid id is already present and updates it in place
+    size_t existing = findSlot(bid.bidId);
+    if (existing != capacity) {
+        slots[existing] = std::move(bid);
+        return;
+    }
+
+    // Grows the table, or just clears deleted markers, before crossing 7/8 load
+    if ((size + deleted + 1) > capacity * 7 / 8) {
+        rehash(size + 1 > capacity * 7 / 16 ? capacity * 2 : capacity);
+    }
+
+    uint64_t h = hash(bid.bidId);
+    int8_t tag = static_cast<int8_t>(h >> 57);
+    size_t numGroups = capacity / GROUP_SIZE;
+    size_t group = (h & (numGroups - 1)) * GROUP_SIZE;
+
+    // Probes for the first empty or deleted slot along the same sequence as findSlot
+    for (size_t step = 1; ; step++) {
+        uint32_t available = matchGroup(group, CTRL_EMPTY) | matchGroup(group, CTRL_DELETED);
+        if (available != 0) {
+            size_t index = group + firstMatch(available);
+            if (ctrl[index] == CTRL_DELETED) {
+                deleted--;
+            }
+            ctrl[index] = tag;
+            slots[index] = std::move(bid);
+            size++;
+            return;
+        }
+
+        group = (group + step * GROUP_SIZE) & (capacity - 1);
+    }
+}
+
+/**
+ * Print all bids
+ */
+void FlatHashTable::PrintAll() {
+    // Iterates through the slot array and prints only the full slots
+    for (size_t i = 0; i < capacity; i++) {
+        if (ctrl[i] >= 0) {
+            Bid& bid = slots[i];
+            cout << i << " | " << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+                << bid.fund << endl;
+        }
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @param bidId The bid id to search for
+ */
+void FlatHashTable::Remove(string bidId) {
+    size_t index = findSlot(bidId);
+
+    // Checks if the bid id was not found
+    if (index == capacity) {
+        cout << "Associated node not found!" << endl;
+        return;
+    }
+
+    // Displays the soon to be removed bid's details to the screen
+    Bid& bid = slots[index];
+    cout << index << " | " << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+        << bid.fund << endl;
+
+    // A slot in a group that still has an empty slot can become empty again,
+    // since no probe sequence could have continued past that group
+    size_t group = index & ~(GROUP_SIZE - 1);
+    if (matchGroup(group, CTRL_EMPTY) != 0) {
+        ctrl[index] = CTRL_EMPTY;
+    }
+    else {
+        ctrl[index] = CTRL_DELETED;
+        deleted++;
+    }
+
+    slots[index] = Bid();
+    size--;
+    cout << "Removed Bid" << endl;
+}
+
+/**
+ * Search for the specified bidId
+ *
+ * @param bidId The bid id to search for
+ */
+Bid FlatHashTable::Search(string bidId) {
+    size_t index = findSlot(bidId);
+
+    // Returns an empty bid if the associated bid is not found
+    if (index == capacity) {
+        return Bid();
     }
-};
+
+    return slots[index];
+}
+
+/**
+ * Returns the number of bids in the table
+ */
+size_t FlatHashTable::Size() {
+    return size;
+}
+
+/**
+ * Grow the table so it can hold count bids without rehashing
+ *
+ * @param count The number of bids the table should be able to hold
+ */
+void FlatHashTable::Reserve(size_t count) {
+    // Doubles a copy of the capacity until the bids fit at 7/8 load
+    size_t newCapacity = capacity;
+    while (newCapacity * 7 / 8 < count) {
+        newCapacity *= 2;
+    }
+
+    // Rehashes only if the table has to grow
+    if (newCapacity != capacity) {
+        rehash(newCapacity);
+    }
+}
 
 //============================================================================
-// Hash Table class definition
+// Concurrent Hash Table class definition
 //============================================================================
 
 /**
  * Define a class containing data members and methods to
- * implement a hash table with chaining.
+ * implement a sharded hash table that is safe to use from many threads.
+ *
+ * Bids are spread over a power of two number of independent HashTable
+ * shards chosen by mixed hash bits, and each shard has its own
+ * reader-writer lock. Writers only exclude operations on the same
+ * shard, so parallel inserts scale with threads and a Search never
+ * waits behind a write to an unrelated shard. Shards keep incremental
+ * rehashing disabled so Search does not modify a shard under its
+ * shared lock.
  */
-class HashTable {
+template <typename HashPolicy = StringHash>
+class ConcurrentHashTable {
 
 private:
-    // Define structures to hold bids
-    struct Node {
-        Bid bid;
-        unsigned int key;
-        Node *next;
-
-        // default constructor
-        Node() {
-            key = UINT_MAX;
-            next = nullptr;
-        }
-
-        // initialize with a bid
-        Node(Bid aBid) : Node() {
-            bid = aBid;
-        }
-
-        // initialize with a bid and a key
-        Node(Bid aBid, unsigned int aKey) : Node(aBid) {
-            key = aKey;
-        }
+    // Define a structure pairing a sub-table with its lock, padded to its
+    // own cache lines so neighbouring locks do not falsely share
+    struct alignas(64) Shard {
+        mutable shared_mutex lock;
+        HashTable<HashPolicy> table;
     };
 
-    vector<Node> nodes;
+    vector<unique_ptr<Shard>> shards;
+    unsigned int shardMask = 0;
 
-    unsigned int tableSize = DEFAULT_SIZE;
+    // Hash policy used to select a shard
+    HashPolicy hasher;
 
-    unsigned int hash(int key);
+    Shard& shardFor(const string& bidId);
 
 public:
-    HashTable();
-    HashTable(unsigned int size);
-    virtual ~HashTable();
+    ConcurrentHashTable();
+    ConcurrentHashTable(unsigned int shardCount);
+    virtual ~ConcurrentHashTable();
     void Insert(Bid bid);
     void PrintAll();
     void Remove(string bidId);
     Bid Search(string bidId);
     size_t Size();
+    void Reserve(size_t count);
 };
 
 /**
  * Default constructor
  */
-HashTable::HashTable() {   
-    // Resizes the nodes array to the current tableSize var
-    nodes.resize(tableSize);
+template <typename HashPolicy>
+ConcurrentHashTable<HashPolicy>::ConcurrentHashTable() : ConcurrentHashTable(DEFAULT_SHARD_COUNT) {
 }
 
 /**
- * Constructor for specifying size of the table
- * Use to improve efficiency of hashing algorithm
- * by reducing collisions without wasting memory.
+ * Constructor for specifying the number of shards
+ * The count is rounded up to a power of two so a shard is picked with a mask.
  */
-HashTable::HashTable(unsigned int size) {
-    // Updates the tableSize var
-    this->tableSize = size;
-    // Resizes the nodes array to the passed in size var
-    nodes.resize(size);
-}
+template <typename HashPolicy>
+ConcurrentHashTable<HashPolicy>::ConcurrentHashTable(unsigned int shardCount) {
+    // Rounds the shard count up to a power of two
+    unsigned int count = 1;
+    while (count < shardCount) {
+        count *= 2;
+    }
 
+    shardMask = count - 1;
+    for (unsigned int i = 0; i < count; i++) {
+        shards.push_back(unique_ptr<Shard>(new Shard()));
+    }
+}
 
 /**
  * Destructor
  */
-HashTable::~HashTable() {
-    // Removes all elements in the node starting from the beginning of the vector
-    nodes.erase(nodes.begin());
+template <typename HashPolicy>
+ConcurrentHashTable<HashPolicy>::~ConcurrentHashTable() {
+    // The shards and their tables are released with the vector
 }
 
 /**
- * Calculate the hash value of a given key.
- * Note that key is specifically defined as
- * unsigned int to prevent undefined results
- * of a negative list index.
+ * Select the shard responsible for a bid id
+ * The policy's hash is re-mixed first so policies with weak high or low
+ * bits (such as NumericIdHash) still spread over every shard.
  *
- * @param key The key to hash
- * @return The calculated hash
+ * @param bidId The bid id to locate
  */
-unsigned int HashTable::hash(int key) {
-    // Calculates the hash key using the current tableSize value
-    return key % this->tableSize;
+template <typename HashPolicy>
+typename ConcurrentHashTable<HashPolicy>::Shard& ConcurrentHashTable<HashPolicy>::shardFor(const string& bidId) {
+    uint64_t h = hasher(bidId);
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return *shards[h & shardMask];
 }
 
 /**
@@ -135,59 +2355,24 @@ unsigned int HashTable::hash(int key) {
  *
  * @param bid The bid to insert
  */
-void HashTable::Insert(Bid bid) {
-    // Calls the hash function to create the hash key using the bid's id
-        // The bid Id string is parsed into a integer and for use in the hash function
-    unsigned int nodeKey = hash(atoi(bid.bidId.c_str()));
-    
-    // Points to the address of the element located at the nodeKey index
-    Node* currNode = &(nodes[nodeKey]);
-
-    // Checks if the currNode is pointing to a null value
-    if (currNode == nullptr) {
-        // Point to a new Node
-        currNode = new Node(bid, nodeKey);
-    }
-    // Checks if the node is empty after a removal based on its key value
-    else if (currNode->key == UINT_MAX) {
-        // Set's currNode's bid and key property to their new values
-        currNode->bid = bid;
-        currNode->key = nodeKey;
-    }
-    else {
-        // Iterates through the singularly linked list until an null pointer is reached
-        while (currNode->next != nullptr) {
-            // Moves to the next element in the singularly linked list
-            currNode = currNode->next;
-        }
+template <typename HashPolicy>
+void ConcurrentHashTable<HashPolicy>::Insert(Bid bid) {
+    Shard& shard = shardFor(bid.bidId);
 
-        // Points the last element's next pointer to a new Node instantiated with the passed in bid and calculated key value
-        currNode->next = new Node(bid, nodeKey);
-    }
+    // Takes the shard's lock exclusively for the duration of the insert
+    unique_lock<shared_mutex> guard(shard.lock);
+    shard.table.Insert(std::move(bid));
 }
 
 /**
  * Print all bids
  */
-void HashTable::PrintAll() {
-    // Iterates through the nodes vector
-    for (int i = 0; i < nodes.size(); i++) {
-        // Points to the Node located at the nodes vector's index
-        Node* currNode = &(nodes[i]);
-
-        // Checks that the node is not empty
-        if (currNode != nullptr && currNode->key != UINT_MAX) {
-            // Loops through the singularly linked list until a null pointer is reached
-            while (currNode != nullptr) {
-                // Sets the node's bid to a local var
-                Bid bid = currNode->bid;
-                // Prints the information associated with the bid object to the console
-                cout << currNode->key << " | " << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-                    << bid.fund << endl;
-                // Points to the next element in the singularly linked list
-                currNode = currNode->next;
-            }
-        }
+template <typename HashPolicy>
+void ConcurrentHashTable<HashPolicy>::PrintAll() {
+    // Prints each shard in turn under its shared lock
+    for (auto& shard : shards) {
+        shared_lock<shared_mutex> guard(shard->lock);
+        shard->table.PrintAll();
     }
 }
 
@@ -196,57 +2381,13 @@ void HashTable::PrintAll() {
  *
  * @param bidId The bid id to search for
  */
-void HashTable::Remove(string bidId) {
-    // Calls the hash function to create the hash key using the bid's id
-        // The bid Id string is parsed into a integer and for use in the hash function 
-    unsigned int nodeKey = hash(atoi(bidId.c_str()));
-
-    // Initializes a pointer and points to the element located at the hash index
-    Node* currNode = &(nodes[nodeKey]);
-
-    // Checks if the pointer is not pointing to a null value and is not empty from deletion node
-    if (currNode != nullptr && currNode->key != UINT_MAX) {
-        // Checks if the next node is pointing to a null value and the node's bid id is equal to the bidId,
-            // indicating that this node is the only element in the singularly linked list and it is the node to be deleted
-        if (currNode->next == nullptr && currNode->bid.bidId == bidId) {
-            // Set's the current node's key to UINT_MAX indicating it is empty from deletion
-            currNode->key = UINT_MAX;
-            // Exits the function
-            return;
-        }
-        else {
-            // Initialize a new prevNode pointer to point to the previous node in the singly linked list
-            Node* prevNode = currNode;
-            // Iterates the currNode to the next node in the singly linked list
-            currNode = currNode->next;
-
-            // Loops through the singularly linked list until the current node's pointer is null
-            while (currNode != nullptr) {
-                // Checks if the currNode's bidId is equal to the passed in bidId
-                if (currNode->bid.bidId == bidId) {
-                    // Initializes a local bid var
-                    Bid bid = currNode->bid;
-                    // Displays the soon to be removed bid's details to the screen
-                    cout << currNode->key << " | " << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-                        << bid.fund << endl;
-                    // Points the prevNode's next pointer to the currNode's next pointer
-                    prevNode->next = currNode->next;
-                    // Removes the currNode from the singly linked list
-                    delete currNode;
-                    // Displays a message indicating that the bid was removed
-                    cout << "Removed Bid" << endl;
-                    // Exits the function
-                    return;
-                }
-
-                prevNode = currNode;
-                currNode = currNode->next;
-            }
-        }
-    }
+template <typename HashPolicy>
+void ConcurrentHashTable<HashPolicy>::Remove(string bidId) {
+    Shard& shard = shardFor(bidId);
 
-    // Displays a message indicating the node was not found
-    cout << "Associated node not found!" << endl;
+    // Takes the shard's lock exclusively for the duration of the removal
+    unique_lock<shared_mutex> guard(shard.lock);
+    shard.table.Remove(bidId);
 }
 
 /**
@@ -254,34 +2395,41 @@ void HashTable::Remove(string bidId) {
  *
  * @param bidId The bid id to search for
  */
-Bid HashTable::Search(string bidId) {
-    // Initializes an local bid with an empty bid
-    Bid bid = Bid();
+template <typename HashPolicy>
+Bid ConcurrentHashTable<HashPolicy>::Search(string bidId) {
+    Shard& shard = shardFor(bidId);
 
-    // Calls the hash function to create the hash key using the bid's id
-        // The bid Id string is parsed into a integer and for use in the hash function 
-    unsigned int nodeKey = hash(atoi(bidId.c_str()));
-
-    // Initializes a pointer and points to the element located at the hash index
-    Node* currNode = &(nodes[nodeKey]);
-
-    // Checks if the currNode is not pointing to a null value and is not empty from deletion node
-    if (currNode != nullptr && currNode->key != UINT_MAX) {
-        // Loops through the singularly linked list until a null value is reached
-        while (currNode != nullptr) {
-            // Checks if the currNode's bidId is equal to the passed in bidId
-            if (currNode->bid.bidId == bidId) {
-                // Returns the node's bid
-                return currNode->bid;
-            }
+    // Shares the shard's lock with other readers
+    shared_lock<shared_mutex> guard(shard.lock);
+    return shard.table.Search(bidId);
+}
 
-            // Points to the next element in the singularly linked list
-            currNode = currNode->next;
-        }
+/**
+ * Returns the number of bids in the table
+ */
+template <typename HashPolicy>
+size_t ConcurrentHashTable<HashPolicy>::Size() {
+    size_t total = 0;
+    for (auto& shard : shards) {
+        shared_lock<shared_mutex> guard(shard->lock);
+        total += shard->table.Size();
     }
+    return total;
+}
 
-    // Returns the empty bid if the associated bid is not found.
-    return bid;
+/**
+ * Grow every shard so the table can hold count bids without rehashing
+ *
+ * @param count The number of bids the table should be able to hold
+ */
+template <typename HashPolicy>
+void ConcurrentHashTable<HashPolicy>::Reserve(size_t count) {
+    // Gives each shard its share of the bids plus some slack for uneven spread
+    size_t perShard = count / shards.size() + count / (shards.size() * 8) + 1;
+    for (auto& shard : shards) {
+        unique_lock<shared_mutex> guard(shard->lock);
+        shard->table.Reserve(perShard);
+    }
 }
 
 //============================================================================
@@ -301,11 +2449,13 @@ void displayBid(Bid bid) {
 
 /**
  * Load a CSV file containing bids into a container
+ * Works with any table exposing Insert(Bid), e.g. HashTable or FlatHashTable
  *
  * @param csvPath the path to the CSV file to load
  * @return a container holding all the bids read
  */
-void loadBids(string csvPath, HashTable* hashTable) {
+template <typename Table>
+void loadBids(string csvPath, Table* hashTable) {
     cout << "Loading CSV file " << csvPath << endl;
 
     // initialize the CSV Parser using the given path
@@ -318,6 +2468,9 @@ void loadBids(string csvPath, HashTable* hashTable) {
     }
     cout << "" << endl;
 
+    // Sizes the table for the known row count up front to avoid repeated rehashing
+    hashTable->Reserve(hashTable->Size() + file.rowCount());
+
     try {
         // loop to read rows of a CSV file
         for (unsigned int i = 0; i < file.rowCount(); i++) {
@@ -339,6 +2492,61 @@ void loadBids(string csvPath, HashTable* hashTable) {
     }
 }
 
+/**
+ * Load a CSV file containing bids into a concurrent table using several threads
+ * The rows are split into contiguous ranges and each thread builds and
+ * inserts the bids of its own range.
+ *
+ * @param csvPath the path to the CSV file to load
+ * @param hashTable the concurrent table to insert into
+ * @param threadCount number of loader threads, 0 for one per hardware thread
+ */
+template <typename HashPolicy>
+void loadBidsParallel(string csvPath, ConcurrentHashTable<HashPolicy>* hashTable, unsigned int threadCount = 0) {
+    cout << "Loading CSV file " << csvPath << endl;
+
+    // initialize the CSV Parser using the given path
+    csv::Parser file = csv::Parser(csvPath);
+    unsigned int rowCount = file.rowCount();
+
+    // Sizes the table for the known row count up front to avoid rehashing under the locks
+    hashTable->Reserve(hashTable->Size() + rowCount);
+
+    // Uses one thread per hardware thread unless told otherwise
+    if (threadCount == 0) {
+        threadCount = max(1u, thread::hardware_concurrency());
+    }
+
+    // Starts the loader threads, each inserting one contiguous range of rows
+    vector<thread> loaders;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        unsigned int first = static_cast<unsigned int>(rowCount * 1ULL * t / threadCount);
+        unsigned int last = static_cast<unsigned int>(rowCount * 1ULL * (t + 1) / threadCount);
+
+        loaders.emplace_back([&file, hashTable, first, last]() {
+            try {
+                for (unsigned int i = first; i < last; i++) {
+                    // Create a data structure and add to the collection of bids
+                    Bid bid;
+                    bid.bidId = file[i][1];
+                    bid.title = file[i][0];
+                    bid.fund = file[i][8];
+                    bid.amount = strToDouble(file[i][4], '$');
+
+                    hashTable->Insert(bid);
+                }
+            } catch (csv::Error &e) {
+                std::cerr << e.what() << std::endl;
+            }
+        });
+    }
+
+    // Waits for every loader thread to finish
+    for (thread& loader : loaders) {
+        loader.join();
+    }
+}
+
 /**
  * Simple C function to convert a string to a double
  * after stripping out unwanted char
@@ -352,6 +2560,150 @@ double strToDouble(string str, char ch) {
     return atof(str.c_str());
 }
 
+#ifdef HASH_TABLE_SELF_TEST
+
+//============================================================================
+// Self-tests, built in place of the menu with -DHASH_TABLE_SELF_TEST
+// (and without NDEBUG, so the asserts are active)
+//============================================================================
+
+/**
+ * Test that the fund index stays consistent when ids are inserted and removed twice
+ * Each id is inserted a second time under a different fund, which must move
+ * it rather than add a copy, and is then removed twice, the second time
+ * finding nothing. Every bid the fund iterators return must be a stored bid
+ * of that fund.
+ */
+void testFundIndex() {
+    HashTable<> table;
+    const unsigned int bidCount = 4;
+
+    // Inserts every id under fund A, then again with the odd ids moved to fund B
+    for (unsigned int i = 0; i < bidCount; i++) {
+        Bid bid;
+        bid.bidId = to_string(90000 + i);
+        bid.fund = "A";
+        table.Insert(bid);
+        bid.fund = i % 2 == 0 ? "A" : "B";
+        table.Insert(bid);
+    }
+    assert(table.Size() == bidCount);
+    assert(table.FundSize("A") == bidCount / 2);
+    assert(table.FundSize("B") == bidCount / 2);
+
+    // Removes the first id of each fund twice
+    for (unsigned int i = 0; i < 2; i++) {
+        table.Remove(to_string(90000 + i));
+        table.Remove(to_string(90000 + i));
+    }
+
+    // Visits both funds, every bid must be stored and filed under its own fund
+    for (const string fund : { "A", "B" }) {
+        size_t visited = 0;
+        for (const Bid& fundBid : table.BidsForFund(fund)) {
+            assert(!fundBid.bidId.empty() && fundBid.fund == fund);
+            assert(!table.Search(fundBid.bidId).bidId.empty());
+            visited++;
+        }
+        assert(visited == bidCount / 2 - 1 && visited == table.FundSize(fund));
+    }
+}
+
+/**
+ * Test that a record appended after a torn tail survives replay and compaction
+ * The tail left by a crash in the middle of an append must be cut off when
+ * the log is reopened, so the next session's records follow intact ones.
+ */
+void testTornLogTail() {
+    const string logPath = "mutation_log_self_test.log";
+    remove(logPath.c_str());
+
+    // Logs one removal, then appends the first bytes of a record that never finished
+    {
+        MutationLog log(logPath);
+        log.AppendRemove("A");
+    }
+    FILE* torn = fopen(logPath.c_str(), "ab");
+    fwrite("\x20\0\0", 1, 3, torn);
+    fclose(torn);
+
+    // Logs a second removal in a new session
+    {
+        MutationLog log(logPath);
+        log.AppendRemove("B");
+    }
+
+    // Both removals must replay, before and after compaction
+    for (int pass = 0; pass < 2; pass++) {
+        string replayed;
+        MutationLog::Replay(logPath, [&replayed](char op, Bid& bid) {
+            replayed += op + bid.bidId;
+        });
+        assert(replayed == "RARB");
+
+        MutationLog log(logPath);
+        assert(log.Compact() == 2);
+    }
+
+    remove(logPath.c_str());
+}
+
+/**
+ * Test that compaction only cancels a remove against the insert that created the id
+ * A remove of an id that existed before the log, here one only ever
+ * replaced, must survive compaction or the bid would come back on replay.
+ */
+void testLogCompaction() {
+    const string logPath = "mutation_log_self_test.log";
+    remove(logPath.c_str());
+
+    {
+        MutationLog log(logPath);
+        Bid bid;
+
+        // X is created, overwritten and removed, which cancels out entirely
+        bid.bidId = "X";
+        log.AppendInsert(bid);
+        log.AppendReplace(bid);
+        log.AppendRemove("X");
+
+        // Y comes from the CSV file, so only its overwrite is redundant
+        bid.bidId = "Y";
+        log.AppendReplace(bid);
+        log.AppendRemove("Y");
+
+        // Z is removed from the CSV file, then created and removed again
+        bid.bidId = "Z";
+        log.AppendRemove("Z");
+        log.AppendInsert(bid);
+        log.AppendRemove("Z");
+
+        assert(log.Compact() == 2);
+    }
+
+    string replayed;
+    MutationLog::Replay(logPath, [&replayed](char op, Bid& bid) {
+        replayed += op + bid.bidId;
+    });
+    assert(replayed == "RYRZ");
+
+    remove(logPath.c_str());
+}
+
+/**
+ * Run every self-test, stopping at the first failed assert
+ */
+int main() {
+    testFundIndex();
+    testTornLogTail();
+    testLogCompaction();
+
+    cout << "All self-tests passed" << endl;
+    return 0;
+}
+
+#else
+
 /**
  * The one and only main() method
  */
@@ -377,10 +2729,28 @@ int main(int argc, char* argv[]) {
     clock_t ticks;
 
     // Define a hash table to hold all the bids
-    HashTable* bidTable;
+    HashTable<>* bidTable;
+    // Define an open-addressing hash table as an alternative store
+    FlatHashTable* flatTable;
+    // Define a sharded hash table that is loaded by several threads
+    ConcurrentHashTable<>* concurrentTable;
+    // Records removals from the chained table so they survive a restart
+    MutationLog* mutationLog = nullptr;
+    string logPath = csvPath + ".log";
+    // Selects which of the tables the menu operates on
+    // (0 = chained, 1 = open-addressing, 2 = concurrent)
+    int tableType = 0;
 
     Bid bid;
-    bidTable = new HashTable();
+    bidTable = new HashTable<>();
+    flatTable = new FlatHashTable();
+    concurrentTable = new ConcurrentHashTable<>();
+    // Spreads rehashing over later operations so interactive lookups never stall
+    bidTable->SetIncrementalRehash(true);
+    // Counts search comparisons for the statistics report
+    bidTable->SetCollectStats(true);
+    // Answers most lookups of missing ids without walking a chain
+    bidTable->EnableBloomFilter(0.01);
     
     int choice = 0;
     while (choice != 9) {
@@ -389,6 +2759,9 @@ int main(int argc, char* argv[]) {
         cout << "  2. Display All Bids" << endl;
         cout << "  3. Find Bid" << endl;
         cout << "  4. Remove Bid" << endl;
+        cout << "  5. Switch Table Type" << endl;
+        cout << "  6. Display Table Statistics" << endl;
+        cout << "  7. Display Bids by Fund" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -401,7 +2774,25 @@ int main(int argc, char* argv[]) {
             ticks = clock();
 
             // Complete the method call to load the bids
-            loadBids(csvPath, bidTable);
+            if (tableType == 1) {
+                loadBids(csvPath, flatTable);
+                cout << flatTable->Size() << " bids read" << endl;
+            } else if (tableType == 2) {
+                loadBidsParallel(csvPath, concurrentTable);
+                cout << concurrentTable->Size() << " bids read" << endl;
+            } else {
+                // Loads the file without logging, the log only holds later changes
+                bidTable->AttachLog(nullptr);
+                loadBids(csvPath, bidTable);
+                cout << bidTable->Size() << " bids read" << endl;
+
+                // Reapplies the changes logged by earlier runs on the first load
+                if (mutationLog == nullptr) {
+                    cout << bidTable->ReplayLog(logPath) << " logged changes replayed" << endl;
+                    mutationLog = new MutationLog(logPath);
+                }
+                bidTable->AttachLog(mutationLog);
+            }
 
             // Calculate elapsed time and display result
             ticks = clock() - ticks; // current clock ticks minus starting clock ticks
@@ -410,13 +2801,25 @@ int main(int argc, char* argv[]) {
             break;
 
         case 2:
-            bidTable->PrintAll();
+            if (tableType == 1) {
+                flatTable->PrintAll();
+            } else if (tableType == 2) {
+                concurrentTable->PrintAll();
+            } else {
+                bidTable->PrintAll();
+            }
             break;
 
         case 3:
             ticks = clock();
 
-            bid = bidTable->Search(bidKey);
+            if (tableType == 1) {
+                bid = flatTable->Search(bidKey);
+            } else if (tableType == 2) {
+                bid = concurrentTable->Search(bidKey);
+            } else {
+                bid = bidTable->Search(bidKey);
+            }
 
             ticks = clock() - ticks; // current clock ticks minus starting clock ticks
 
@@ -431,7 +2834,62 @@ int main(int argc, char* argv[]) {
             break;
 
         case 4:
-            bidTable->Remove(bidKey);
+            if (tableType == 1) {
+                flatTable->Remove(bidKey);
+            } else if (tableType == 2) {
+                concurrentTable->Remove(bidKey);
+            } else {
+                bidTable->Remove(bidKey);
+                // Makes the removal durable before returning to the menu
+                if (mutationLog != nullptr && !mutationLog->Sync()) {
+                    cout << "Warning: the removal was not saved and may be lost on restart" << endl;
+                }
+            }
+            break;
+
+        case 5:
+            // Cycles through the chained, open-addressing and concurrent tables
+            tableType = (tableType + 1) % 3;
+            cout << "Using " << (tableType == 1 ? "open-addressing" : tableType == 2 ? "concurrent" : "chained")
+                << " hash table" << endl;
+            break;
+
+        case 6:
+            // Statistics are collected by the chained table only
+            if (tableType != 0) {
+                cout << "Statistics are only available for the chained hash table" << endl;
+                break;
+            }
+
+            bidTable->PrintStats();
+
+            // Writes the same statistics as JSON for later analysis
+            {
+                ofstream statsFile("hashtable_stats.json");
+                bidTable->DumpStats(statsFile);
+                cout << "Statistics written to hashtable_stats.json" << endl;
+            }
+            break;
+
+        case 7:
+            // The fund index is kept by the chained table only
+            if (tableType != 0) {
+                cout << "Fund lookups are only available for the chained hash table" << endl;
+                break;
+            }
+
+            // Prompts for the fund and displays only the bids indexed under it
+            {
+                string fund;
+                cout << "Enter fund: ";
+                // Reads the whole line so fund names with spaces are not split
+                getline(cin >> ws, fund);
+
+                for (const Bid& fundBid : bidTable->BidsForFund(fund)) {
+                    displayBid(fundBid);
+                }
+                cout << bidTable->FundSize(fund) << " bids in fund " << fund << endl;
+            }
             break;
         case 9:
             // breaks the switch statement if the exit value is entered
@@ -452,7 +2910,15 @@ int main(int argc, char* argv[]) {
         
     }
 
+    // Drops cancelled operations from the log before closing it
+    if (mutationLog != nullptr) {
+        mutationLog->Compact();
+        delete mutationLog;
+    }
+
     cout << "Good bye." << endl;
 
     return 0;
 }
+
+#endif // HASH_TABLE_SELF_TEST
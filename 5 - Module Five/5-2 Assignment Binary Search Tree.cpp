@@ -6,10 +6,37 @@
 // Description : Lab 5-2 Binary Search Tree
 //============================================================================
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional> // hash
 #include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
 #include <time.h>
 
+// hint the cache to start loading an address that will be read soon
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(address) __builtin_prefetch(address)
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define PREFETCH(address) _mm_prefetch(reinterpret_cast<const char*>(address), _MM_HINT_T0)
+#else
+#define PREFETCH(address) ((void)(address))
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h> // SSE2 Node16 search
+#define ART_SSE2 1
+#endif
+
 #include "CSVparser.hpp"
+#include "../BloomFilter.hpp"
+#include "../OrderedMap.hpp"
 
 using namespace std;
 
@@ -17,6 +44,12 @@ using namespace std;
 // Global definitions visible to all methods and classes
 //============================================================================
 
+// number of readers that can be inside a ConcurrentBidTree at the same time
+const unsigned int READER_SLOTS = 64;
+
+// removed nodes a ConcurrentBidTree collects before trying to free them
+const size_t RECLAIM_THRESHOLD = 64;
+
 // forward declarations
 double strToDouble(string str, char ch);
 
@@ -36,20 +69,253 @@ struct Node {
     Bid bid;
     Node *left;
     Node *right;
+    // height of the subtree rooted here, kept up to date in balanced mode
+    int height;
+    // true when the node lives in a block allocated by BulkLoad rather than on its own
+    bool pooled;
+    // number of nodes in the subtree rooted here, including this one
+    size_t subtreeSize;
+    // total, smallest and largest bid amount in the subtree rooted here
+    double amountTotal;
+    double amountMin;
+    double amountMax;
 
     // default constructor
     Node() {
         left = nullptr;
         right = nullptr;
+        height = 1;
+        pooled = false;
+        subtreeSize = 1;
+        amountTotal = 0.0;
+        amountMin = 0.0;
+        amountMax = 0.0;
     }
 
     // initialize with a bid
     Node(Bid aBid) :
             Node() {
         bid = aBid;
+        amountTotal = bid.amount;
+        amountMin = bid.amount;
+        amountMax = bid.amount;
     }
 };
 
+// define a structure to hold the totals of the amounts of a set of bids
+struct AmountSummary {
+    size_t count;
+    double total;
+    double minimum;
+    double maximum;
+    AmountSummary() {
+        count = 0;
+        total = 0.0;
+        minimum = 0.0;
+        maximum = 0.0;
+    }
+};
+
+//============================================================================
+// Frozen (Eytzinger layout) tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a read-only snapshot of a tree's bids in Eytzinger order.
+ *
+ * The bids are stored in one array in breadth-first order of a perfectly
+ * balanced tree: the children of position k sit at 2k and 2k + 1, so no
+ * pointers are stored and the top levels share a few cache lines. A search
+ * descends through a parallel array of packed eight-byte key prefixes with
+ * no unpredictable branches, prefetching the keys four levels below.
+ */
+class FrozenBidTree {
+
+private:
+    // Packed key prefixes and bids, both 1-based in Eytzinger order, index 0 unused
+    vector<uint64_t> prefixes;
+    vector<Bid> bids;
+    size_t count = 0;
+
+    static uint64_t prefixOf(const string& key);
+    static size_t trailingOnes(size_t position);
+    size_t place(vector<Bid>& sortedBids, size_t next, size_t position);
+    size_t first() const;
+    size_t successor(size_t position) const;
+
+public:
+    FrozenBidTree(vector<Bid> sortedBids);
+    Bid Search(const string& bidId) const;
+    void InOrder() const;
+    vector<Bid> TakeSorted();
+    size_t Size() const;
+};
+
+/**
+ * Construct the snapshot from bids sorted by id
+ *
+ * @param sortedBids The bids in id order, moved into the snapshot
+ */
+FrozenBidTree::FrozenBidTree(vector<Bid> sortedBids) {
+    count = sortedBids.size();
+    prefixes.assign(count + 1, 0);
+    bids.resize(count + 1);
+    place(sortedBids, 0, 1);
+}
+
+/**
+ * Pack a key's first eight bytes into an integer that orders like the key
+ *
+ * @param key The bid id
+ */
+uint64_t FrozenBidTree::prefixOf(const string& key) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; i++) {
+        prefix <<= 8;
+        if (i < key.size()) {
+            prefix |= static_cast<unsigned char>(key[i]);
+        }
+    }
+    return prefix;
+}
+
+/**
+ * Returns the number of consecutive one bits at the bottom of a position
+ */
+size_t FrozenBidTree::trailingOnes(size_t position) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(~static_cast<unsigned long long>(position));
+#else
+    size_t ones = 0;
+    while ((position & 1) != 0) {
+        position >>= 1;
+        ones++;
+    }
+    return ones;
+#endif
+}
+
+/**
+ * Fill a subtree's positions with the next bids in order (recursive, the depth is log n)
+ *
+ * @param sortedBids The bids in id order
+ * @param next The index of the next bid to place
+ * @param position The subtree's root position
+ * @return The index of the next bid left to place
+ */
+size_t FrozenBidTree::place(vector<Bid>& sortedBids, size_t next, size_t position) {
+    if (position > count) {
+        return next;
+    }
+
+    next = place(sortedBids, next, 2 * position);
+    prefixes[position] = prefixOf(sortedBids[next].bidId);
+    bids[position] = std::move(sortedBids[next++]);
+    return place(sortedBids, next, 2 * position + 1);
+}
+
+/**
+ * Returns the position of the smallest id, zero when the snapshot is empty
+ */
+size_t FrozenBidTree::first() const {
+    if (count == 0) {
+        return 0;
+    }
+
+    size_t position = 1;
+    while (2 * position <= count) {
+        position *= 2;
+    }
+    return position;
+}
+
+/**
+ * Returns the position of the next id in order, zero after the last one
+ */
+size_t FrozenBidTree::successor(size_t position) const {
+    // Goes to the leftmost position of the right subtree if there is one
+    if (2 * position + 1 <= count) {
+        position = 2 * position + 1;
+        while (2 * position <= count) {
+            position *= 2;
+        }
+        return position;
+    }
+
+    // Otherwise climbs past every ancestor it is a right child of, and one more
+    return position >> (trailingOnes(position) + 1);
+}
+
+/**
+ * Search for a bid
+ *
+ * @param bidId The id to look up
+ * @return The bid, or an empty bid if the id is not in the snapshot
+ */
+Bid FrozenBidTree::Search(const string& bidId) const {
+    uint64_t prefix = prefixOf(bidId);
+    const uint64_t* keys = prefixes.data();
+
+    // Descends every level, the comparison result choosing the child arithmetically
+    size_t position = 1;
+    while (position <= count) {
+        // The sixteen positions four levels down are contiguous, two cache lines
+        PREFETCH(keys + min(16 * position, count));
+        position = 2 * position + (keys[position] < prefix);
+    }
+
+    // Undoes the final right turns, landing on the first prefix not less than the id's
+    position >>= trailingOnes(position) + 1;
+
+    // Compares the full ids of the bids sharing the prefix, in order
+    while (position != 0 && keys[position] == prefix) {
+        if (bids[position].bidId == bidId) {
+            return bids[position];
+        }
+        if (bids[position].bidId > bidId) {
+            break;
+        }
+        position = successor(position);
+    }
+
+    return Bid();
+}
+
+/**
+ * Traverse the bids in order
+ */
+void FrozenBidTree::InOrder() const {
+    for (size_t position = first(); position != 0; position = successor(position)) {
+        const Bid& bid = bids[position];
+        cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+            << bid.fund << endl;
+    }
+}
+
+/**
+ * Move the bids out in id order, leaving the snapshot empty
+ */
+vector<Bid> FrozenBidTree::TakeSorted() {
+    vector<Bid> sortedBids;
+    sortedBids.reserve(count);
+    for (size_t position = first(); position != 0; position = successor(position)) {
+        sortedBids.push_back(std::move(bids[position]));
+    }
+
+    prefixes.assign(1, 0);
+    bids.resize(1);
+    count = 0;
+    return sortedBids;
+}
+
+/**
+ * Returns the number of bids in the snapshot
+ */
+size_t FrozenBidTree::Size() const {
+    return count;
+}
+
 //============================================================================
 // Binary Search Tree class definition
 //============================================================================
@@ -63,7 +329,33 @@ class BinarySearchTree {
 private:
     Node* root;
 
+    // Optional Bloom filter answering most misses without walking the tree
+    bool useBloomFilter = false;
+    BloomFilter bloomFilter;
+    unsigned long bloomAvoided = 0;
+
+    // Keeps the tree AVL-balanced so sorted input cannot degrade it into a list
+    bool balanced = false;
+
+    // Blocks of nodes allocated together by BulkLoad, freed with the tree
+    vector<Node*> nodeBlocks;
+
     void addNode(Node* node, Bid bid);
+    Node* insertBalanced(Node* node, Bid& bid);
+    static int height(Node* node);
+    static size_t sizeOf(Node* node);
+    static void addToSummary(AmountSummary& summary, const Bid& bid);
+    static void addToSummary(AmountSummary& summary, Node* subtree);
+    static void updateNode(Node* node);
+    static Node* rotateLeft(Node* node);
+    static Node* rotateRight(Node* node);
+    static Node* rebalance(Node* node);
+    static Node* buildBalanced(vector<Node*>& nodes, size_t first, size_t last);
+    void rebuildBalanced();
+    static Node* buildFromSorted(vector<Bid>& bids, size_t first, size_t last, Node* block, size_t& next);
+    static void freeNode(Node* node);
+    void clear();
+    void rebuildBloomFilter(size_t count);
     void inOrder(Node* node);
     void postOrder(Node* node);
     void preOrder(Node* node);
@@ -71,272 +363,3640 @@ private:
     void printNode(Node* node);
 
 public:
+    /**
+     * Define an in-order iterator over the tree's bids
+     * The iterator keeps the path of ancestors still to be visited, so it
+     * needs no parent links and each step costs amortized constant time.
+     * Iterators are invalidated by Insert and Remove.
+     */
+    class Iterator {
+    private:
+        vector<Node*> pending;
+
+        // Pushes a node and its chain of left children, the next bids in order
+        void pushLeft(Node* node) {
+            while (node != nullptr) {
+                pending.push_back(node);
+                node = node->left;
+            }
+        }
+
+        friend class BinarySearchTree;
+
+    public:
+        const Bid& operator*() const {
+            return pending.back()->bid;
+        }
+
+        const Bid* operator->() const {
+            return &pending.back()->bid;
+        }
+
+        Iterator& operator++() {
+            Node* node = pending.back();
+            pending.pop_back();
+            pushLeft(node->right);
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return pending.empty() ? other.pending.empty()
+                : !other.pending.empty() && pending.back() == other.pending.back();
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
     BinarySearchTree();
     virtual ~BinarySearchTree();
+    Iterator begin();
+    Iterator end();
+    Iterator Seek(const string& bidId);
+    size_t Size();
+    size_t Rank(const string& bidId);
+    Bid Select(size_t rank);
+    vector<Bid> RangeScan(const string& lowId, const string& highId);
+    AmountSummary SummarizeAmounts(const string& lowId, const string& highId);
     void InOrder();
     void PostOrder();
     void PreOrder();
     void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
     void Remove(string bidId);
     Bid Search(string bidId);
+    FrozenBidTree* Freeze();
+    void Thaw(FrozenBidTree* frozen);
+    void EnableBloomFilter(double falsePositiveRate);
+    void ReserveBloomFilter(size_t count);
+    unsigned long BloomAvoidedProbes();
+    void SetBalanced(bool enabled);
+    bool IsBalanced();
+    int Height();
 };
 
 /**
- * Default constructor
+ * Default constructor
+ */
+BinarySearchTree::BinarySearchTree() {
+    // Points the start of the tree, the root, to a null value
+    root = nullptr;
+}
+
+/**
+ * Destructor
+ */
+BinarySearchTree::~BinarySearchTree() {
+    clear();
+}
+
+/**
+ * Free every node and leave the tree empty
+ */
+void BinarySearchTree::clear() {
+    // Frees every node with an explicit stack so deep trees cannot overflow the call stack
+    vector<Node*> pending;
+    if (root != nullptr) {
+        pending.push_back(root);
+    }
+    while (!pending.empty()) {
+        Node* currNode = pending.back();
+        pending.pop_back();
+
+        if (currNode->left != nullptr) {
+            pending.push_back(currNode->left);
+        }
+        if (currNode->right != nullptr) {
+            pending.push_back(currNode->right);
+        }
+        freeNode(currNode);
+    }
+
+    // Frees the blocks holding the bulk-loaded nodes
+    for (Node* block : nodeBlocks) {
+        delete[] block;
+    }
+    nodeBlocks.clear();
+    root = nullptr;
+}
+
+/**
+ * Free a node allocated on its own
+ * A bulk-loaded node is part of a block that is freed with the tree, so
+ * only its bid's memory is released here.
+ */
+void BinarySearchTree::freeNode(Node* node) {
+    if (node->pooled) {
+        node->bid = Bid();
+    }
+    else {
+        delete node;
+    }
+}
+
+/**
+ * Returns an iterator at the bid with the smallest id
+ */
+BinarySearchTree::Iterator BinarySearchTree::begin() {
+    Iterator iterator;
+    iterator.pushLeft(root);
+    return iterator;
+}
+
+/**
+ * Returns the iterator positioned past the last bid
+ */
+BinarySearchTree::Iterator BinarySearchTree::end() {
+    return Iterator();
+}
+
+/**
+ * Returns an iterator at the first bid whose id is not less than the given id
+ *
+ * @param bidId The id to seek to
+ */
+BinarySearchTree::Iterator BinarySearchTree::Seek(const string& bidId) {
+    Iterator iterator;
+    Node* currNode = root;
+
+    // Keeps only the nodes at or after the id on the path down
+    while (currNode != nullptr) {
+        if (currNode->bid.bidId < bidId) {
+            currNode = currNode->right;
+        }
+        else {
+            iterator.pending.push_back(currNode);
+            currNode = currNode->left;
+        }
+    }
+    return iterator;
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+size_t BinarySearchTree::Size() {
+    return sizeOf(root);
+}
+
+/**
+ * Count the bids whose ids come before an id
+ *
+ * @param bidId The id to rank, which need not be in the tree
+ * @return The number of bids with a smaller id
+ */
+size_t BinarySearchTree::Rank(const string& bidId) {
+    size_t rank = 0;
+    Node* currNode = root;
+
+    while (currNode != nullptr) {
+        // Counts the node and its left subtree when the whole of it comes first
+        if (currNode->bid.bidId < bidId) {
+            rank += sizeOf(currNode->left) + 1;
+            currNode = currNode->right;
+        }
+        else {
+            currNode = currNode->left;
+        }
+    }
+    return rank;
+}
+
+/**
+ * Find the bid at a position in id order
+ *
+ * @param rank The position, counting from zero
+ * @return The bid, or an empty bid if rank is not less than Size()
+ */
+Bid BinarySearchTree::Select(size_t rank) {
+    Node* currNode = root;
+
+    while (currNode != nullptr) {
+        size_t leftSize = sizeOf(currNode->left);
+        // Checks if the position is in the left subtree, at this node, or in the right subtree
+        if (rank < leftSize) {
+            currNode = currNode->left;
+        }
+        else if (rank == leftSize) {
+            return currNode->bid;
+        }
+        else {
+            rank -= leftSize + 1;
+            currNode = currNode->right;
+        }
+    }
+
+    return Bid();
+}
+
+/**
+ * Collect the bids whose ids fall within a range, in id order
+ *
+ * @param lowId The smallest id to include
+ * @param highId The largest id to include
+ * @return The bids with lowId <= bidId <= highId
+ */
+vector<Bid> BinarySearchTree::RangeScan(const string& lowId, const string& highId) {
+    vector<Bid> bids;
+    for (Iterator it = Seek(lowId); it != end() && it->bidId <= highId; ++it) {
+        bids.push_back(*it);
+    }
+    return bids;
+}
+
+/**
+ * Total the amounts of the bids whose ids fall within a range
+ * Whole subtrees inside the range are taken from their cached totals, so
+ * only the two paths bounding the range are walked: O(log n) when balanced.
+ *
+ * @param lowId The smallest id to include
+ * @param highId The largest id to include
+ * @return The count, total, minimum and maximum amount of the bids with lowId <= bidId <= highId
+ */
+AmountSummary BinarySearchTree::SummarizeAmounts(const string& lowId, const string& highId) {
+    AmountSummary summary;
+
+    // Descends to the first node inside the range, where the two bounding paths split
+    Node* splitNode = root;
+    while (splitNode != nullptr && (splitNode->bid.bidId < lowId || splitNode->bid.bidId > highId)) {
+        splitNode = splitNode->bid.bidId < lowId ? splitNode->right : splitNode->left;
+    }
+    if (splitNode == nullptr) {
+        return summary;
+    }
+    addToSummary(summary, splitNode->bid);
+
+    // Walks the lower bound's path, taking each right subtree above the bound whole
+    Node* currNode = splitNode->left;
+    while (currNode != nullptr) {
+        if (currNode->bid.bidId >= lowId) {
+            addToSummary(summary, currNode->bid);
+            addToSummary(summary, currNode->right);
+            currNode = currNode->left;
+        }
+        else {
+            currNode = currNode->right;
+        }
+    }
+
+    // Walks the upper bound's path, taking each left subtree below the bound whole
+    currNode = splitNode->right;
+    while (currNode != nullptr) {
+        if (currNode->bid.bidId <= highId) {
+            addToSummary(summary, currNode->bid);
+            addToSummary(summary, currNode->left);
+            currNode = currNode->right;
+        }
+        else {
+            currNode = currNode->left;
+        }
+    }
+
+    return summary;
+}
+
+/**
+ * Add one bid's amount to a summary
+ */
+void BinarySearchTree::addToSummary(AmountSummary& summary, const Bid& bid) {
+    summary.minimum = summary.count == 0 ? bid.amount : min(summary.minimum, bid.amount);
+    summary.maximum = summary.count == 0 ? bid.amount : max(summary.maximum, bid.amount);
+    summary.total += bid.amount;
+    summary.count++;
+}
+
+/**
+ * Add a whole subtree's cached amount totals to a summary
+ */
+void BinarySearchTree::addToSummary(AmountSummary& summary, Node* subtree) {
+    if (subtree == nullptr) {
+        return;
+    }
+
+    summary.minimum = summary.count == 0 ? subtree->amountMin : min(summary.minimum, subtree->amountMin);
+    summary.maximum = summary.count == 0 ? subtree->amountMax : max(summary.maximum, subtree->amountMax);
+    summary.total += subtree->amountTotal;
+    summary.count += subtree->subtreeSize;
+}
+
+/**
+ * Traverse the tree in order
+ */
+void BinarySearchTree::InOrder() {
+    // Call the inOrder function and pass in the root to begin traversal
+    inOrder(root);
+}
+
+/**
+ * Traverse the tree in post-order
+ */
+void BinarySearchTree::PostOrder() {
+    // Call the postOrder function and pass in the root to begin traversal
+    postOrder(root);
+}
+
+/**
+ * Traverse the tree in pre-order
+ */
+void BinarySearchTree::PreOrder() {
+    // Call the preOrder function and pass in the root to begin traversal
+    preOrder(root);
+}
+
+
+
+/**
+ * Insert a bid
+ */
+void BinarySearchTree::Insert(Bid bid) {
+    // Records the id in the Bloom filter, doubling the filter once it is overfull
+    if (useBloomFilter) {
+        if (bloomFilter.IsOverCapacity()) {
+            rebuildBloomFilter(bloomFilter.Capacity() * 2);
+        }
+        bloomFilter.Add(bid.bidId);
+    }
+
+    // Inserts with AVL rebalancing, which keeps the recursion O(log n) deep
+    if (balanced) {
+        root = insertBalanced(root, bid);
+    }
+    // Check if the tree's root is empty
+    else if (root == nullptr) {
+        // Initialize a new node and assign it to the tree's root
+        root = new Node(bid);
+    }
+    else {
+        // Call the addNode function and pass in the root and new bid to-be added
+        addNode(root, bid);
+    }
+}
+
+/**
+ * Add many bids at once, building a perfectly balanced tree in linear time
+ * Bids already in id order, as in the CSV files, are used as they are;
+ * others are sorted first. Bids already in the tree are merged in, and the
+ * nodes are allocated in one block laid out in pre-order, so a search walks
+ * forward through memory.
+ *
+ * @param bids The bids to add
+ */
+void BinarySearchTree::BulkLoad(vector<Bid> bids) {
+    auto byId = [](const Bid& a, const Bid& b) { return a.bidId < b.bidId; };
+
+    // Sorts the bids only if they are not already in order
+    if (!is_sorted(bids.begin(), bids.end(), byId)) {
+        stable_sort(bids.begin(), bids.end(), byId);
+    }
+
+    // Merges in the bids already in the tree, which the iterator yields in order
+    if (root != nullptr) {
+        vector<Bid> existing;
+        for (Iterator it = begin(); it != end(); ++it) {
+            existing.push_back(*it);
+        }
+
+        vector<Bid> merged;
+        merged.reserve(existing.size() + bids.size());
+        merge(make_move_iterator(existing.begin()), make_move_iterator(existing.end()),
+            make_move_iterator(bids.begin()), make_move_iterator(bids.end()), back_inserter(merged), byId);
+        bids.swap(merged);
+        clear();
+    }
+
+    if (bids.empty()) {
+        return;
+    }
+
+    // Allocates every node in one block and links them into a balanced tree
+    Node* block = new Node[bids.size()];
+    nodeBlocks.push_back(block);
+    size_t next = 0;
+    root = buildFromSorted(bids, 0, bids.size(), block, next);
+
+    // Refills the Bloom filter, sized for at least the bids now in the tree
+    if (useBloomFilter) {
+        rebuildBloomFilter(max(bids.size(), bloomFilter.Capacity()));
+    }
+}
+
+/**
+ * Build a perfectly balanced subtree from a sorted range of bids (recursive)
+ *
+ * @param bids The bids in sorted order, moved into the nodes
+ * @param first The index of the range's first bid
+ * @param last One past the index of the range's last bid
+ * @param block The node block to take nodes from
+ * @param next The index of the block's next unused node
+ * @return The root of the subtree
+ */
+Node* BinarySearchTree::buildFromSorted(vector<Bid>& bids, size_t first, size_t last, Node* block, size_t& next) {
+    if (first >= last) {
+        return nullptr;
+    }
+
+    // Takes the middle bid as the root, claiming the node before its children's
+    size_t middle = first + (last - first) / 2;
+    Node* node = &block[next++];
+    node->bid = std::move(bids[middle]);
+    node->pooled = true;
+    node->left = buildFromSorted(bids, first, middle, block, next);
+    node->right = buildFromSorted(bids, middle + 1, last, block, next);
+    updateNode(node);
+    return node;
+}
+
+/**
+ * Remove a bid
+ */
+void BinarySearchTree::Remove(string bidId) {
+    // Checks if the Bloom filter proves the bid is not in the tree
+    if (useBloomFilter && !bloomFilter.MayContain(bidId)) {
+        bloomAvoided++;
+        return;
+    }
+
+    // Call the removeNode function and pass in the root and id of node to-be removed
+        // The returned node becomes the new root, as the old root may have been removed or rotated away
+    root = removeNode(root, bidId);
+}
+
+/**
+ * Search for a bid
+ */
+Bid BinarySearchTree::Search(string bidId) {
+    // Returns an empty bid right away if the Bloom filter proves the bid is not in the tree
+    if (useBloomFilter && !bloomFilter.MayContain(bidId)) {
+        bloomAvoided++;
+        return Bid();
+    }
+
+    // Initialize a new pointer pointing to the tree's root
+    Node* currNode = root;
+
+    // Traverse the tree until the currNode is null
+    while (currNode != nullptr) {
+        // Check if the currNode's bid matches the passed in bid id
+        if (currNode->bid.bidId == bidId) { // Indicates the desired bid was found
+            // Exit the method and return the currNode's bid
+            return currNode->bid;
+        }
+        // Check if the currNode's bid id is greater than the passed in bid id
+        else if (currNode->bid.bidId > bidId) { // Indicates the left child should be searched
+            // Navigate to the left child
+            currNode = currNode->left;
+        }
+        else { // Indicates the right child should be searched=
+            // Navigate to the right child
+            currNode = currNode->right;
+        }
+    }
+    
+    // Initialize an empty bid
+    Bid bid;
+    // Exit the function and return the empty bid, indicating the bid id has no associated node in the tree
+    return bid;
+}
+
+/**
+ * Export the bids into a read-only Eytzinger-layout snapshot
+ * The tree is left empty; Thaw moves the bids back once edits resume.
+ *
+ * @return The snapshot, owned by the caller
+ */
+FrozenBidTree* BinarySearchTree::Freeze() {
+    // Moves the bids out in order with an explicit stack so deep trees cannot overflow the call stack
+    vector<Bid> sortedBids;
+    sortedBids.reserve(Size());
+    vector<Node*> pending;
+    Node* currNode = root;
+    while (currNode != nullptr || !pending.empty()) {
+        while (currNode != nullptr) {
+            pending.push_back(currNode);
+            currNode = currNode->left;
+        }
+        currNode = pending.back();
+        pending.pop_back();
+        sortedBids.push_back(std::move(currNode->bid));
+        currNode = currNode->right;
+    }
+
+    clear();
+    return new FrozenBidTree(std::move(sortedBids));
+}
+
+/**
+ * Move a snapshot's bids back into the tree, rebuilding it balanced in linear time
+ *
+ * @param frozen The snapshot, left empty
+ */
+void BinarySearchTree::Thaw(FrozenBidTree* frozen) {
+    BulkLoad(frozen->TakeSorted());
+}
+
+/**
+ * Turn on the Bloom filter front-end for Search and Remove
+ *
+ * @param falsePositiveRate The fraction of misses allowed to walk the tree
+ */
+void BinarySearchTree::EnableBloomFilter(double falsePositiveRate) {
+    useBloomFilter = true;
+    bloomFilter.Reset(DEFAULT_BLOOM_CAPACITY, falsePositiveRate);
+    rebuildBloomFilter(DEFAULT_BLOOM_CAPACITY);
+}
+
+/**
+ * Size the Bloom filter for a known number of bids, e.g. before a load
+ *
+ * @param count The number of bids the filter should hold
+ */
+void BinarySearchTree::ReserveBloomFilter(size_t count) {
+    // Resizes only an enabled filter that is currently too small
+    if (useBloomFilter && count > bloomFilter.Capacity()) {
+        rebuildBloomFilter(count);
+    }
+}
+
+/**
+ * Returns the number of lookups the Bloom filter answered without a tree walk
+ */
+unsigned long BinarySearchTree::BloomAvoidedProbes() {
+    return bloomAvoided;
+}
+
+/**
+ * Turn AVL balancing on or off
+ * Turning it on rebuilds the current tree into a perfectly balanced one.
+ *
+ * @param enabled True to keep the tree balanced on every Insert and Remove
+ */
+void BinarySearchTree::SetBalanced(bool enabled) {
+    if (enabled && !balanced) {
+        rebuildBalanced();
+    }
+    balanced = enabled;
+}
+
+/**
+ * Returns true when the tree is kept balanced
+ */
+bool BinarySearchTree::IsBalanced() {
+    return balanced;
+}
+
+/**
+ * Returns the number of levels in the tree
+ */
+int BinarySearchTree::Height() {
+    // Uses the stored heights when they are maintained
+    if (balanced) {
+        return height(root);
+    }
+
+    // Otherwise measures the depth with an explicit stack, an unbalanced tree may be very deep
+    int maxDepth = 0;
+    vector<pair<Node*, int>> pending;
+    if (root != nullptr) {
+        pending.push_back(make_pair(root, 1));
+    }
+    while (!pending.empty()) {
+        Node* node = pending.back().first;
+        int depth = pending.back().second;
+        pending.pop_back();
+
+        maxDepth = max(maxDepth, depth);
+        if (node->left != nullptr) {
+            pending.push_back(make_pair(node->left, depth + 1));
+        }
+        if (node->right != nullptr) {
+            pending.push_back(make_pair(node->right, depth + 1));
+        }
+    }
+    return maxDepth;
+}
+
+/**
+ * Returns the height of a subtree, zero for an empty one
+ */
+int BinarySearchTree::height(Node* node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+/**
+ * Returns the number of nodes in a subtree, zero for an empty one
+ */
+size_t BinarySearchTree::sizeOf(Node* node) {
+    return node == nullptr ? 0 : node->subtreeSize;
+}
+
+/**
+ * Recalculate a node's height, subtree size and amount totals from its children's
+ */
+void BinarySearchTree::updateNode(Node* node) {
+    node->height = 1 + max(height(node->left), height(node->right));
+    node->subtreeSize = 1 + sizeOf(node->left) + sizeOf(node->right);
+
+    node->amountTotal = node->bid.amount;
+    node->amountMin = node->bid.amount;
+    node->amountMax = node->bid.amount;
+    for (Node* child : { node->left, node->right }) {
+        if (child != nullptr) {
+            node->amountTotal += child->amountTotal;
+            node->amountMin = min(node->amountMin, child->amountMin);
+            node->amountMax = max(node->amountMax, child->amountMax);
+        }
+    }
+}
+
+/**
+ * Rotate a subtree left, lifting its right child into its place
+ *
+ * @return The new root of the subtree
+ */
+Node* BinarySearchTree::rotateLeft(Node* node) {
+    Node* newRoot = node->right;
+    node->right = newRoot->left;
+    newRoot->left = node;
+
+    // Updates the lowered node first as the new root's height depends on it
+    updateNode(node);
+    updateNode(newRoot);
+    return newRoot;
+}
+
+/**
+ * Rotate a subtree right, lifting its left child into its place
+ *
+ * @return The new root of the subtree
+ */
+Node* BinarySearchTree::rotateRight(Node* node) {
+    Node* newRoot = node->left;
+    node->left = newRoot->right;
+    newRoot->right = node;
+
+    // Updates the lowered node first as the new root's height depends on it
+    updateNode(node);
+    updateNode(newRoot);
+    return newRoot;
+}
+
+/**
+ * Restore the AVL property at a node whose children are already balanced
+ *
+ * @return The new root of the subtree
+ */
+Node* BinarySearchTree::rebalance(Node* node) {
+    updateNode(node);
+    int balance = height(node->left) - height(node->right);
+
+    // Checks if the left side is two levels taller
+    if (balance > 1) {
+        // Turns a left-right shape into a left-left shape first
+        if (height(node->left->left) < height(node->left->right)) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    // Checks if the right side is two levels taller
+    if (balance < -1) {
+        // Turns a right-left shape into a right-right shape first
+        if (height(node->right->right) < height(node->right->left)) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+
+    return node;
+}
+
+/**
+ * Add a bid below some node and rebalance on the way back up (recursive)
+ *
+ * @param node Current node in tree, may be null
+ * @param bid Bid to be added
+ * @return The new root of the subtree
+ */
+Node* BinarySearchTree::insertBalanced(Node* node, Bid& bid) {
+    // Places the bid once an empty spot is reached
+    if (node == nullptr) {
+        return new Node(bid);
+    }
+
+    // Equal ids go to the right, matching addNode
+    if (node->bid.bidId > bid.bidId) {
+        node->left = insertBalanced(node->left, bid);
+    }
+    else {
+        node->right = insertBalanced(node->right, bid);
+    }
+
+    return rebalance(node);
+}
+
+/**
+ * Link a sorted range of nodes into a perfectly balanced subtree (recursive)
+ *
+ * @param nodes The nodes in sorted order
+ * @param first The index of the range's first node
+ * @param last One past the index of the range's last node
+ * @return The root of the subtree
+ */
+Node* BinarySearchTree::buildBalanced(vector<Node*>& nodes, size_t first, size_t last) {
+    if (first >= last) {
+        return nullptr;
+    }
+
+    // Makes the middle node the root so both halves differ in size by at most one
+    size_t middle = first + (last - first) / 2;
+    Node* node = nodes[middle];
+    node->left = buildBalanced(nodes, first, middle);
+    node->right = buildBalanced(nodes, middle + 1, last);
+    updateNode(node);
+    return node;
+}
+
+/**
+ * Relink every node of the tree into a perfectly balanced shape
+ */
+void BinarySearchTree::rebuildBalanced() {
+    // Collects the nodes in order with an explicit stack so deep trees cannot overflow the call stack
+    vector<Node*> nodes;
+    vector<Node*> pending;
+    Node* currNode = root;
+    while (currNode != nullptr || !pending.empty()) {
+        while (currNode != nullptr) {
+            pending.push_back(currNode);
+            currNode = currNode->left;
+        }
+        currNode = pending.back();
+        pending.pop_back();
+        nodes.push_back(currNode);
+        currNode = currNode->right;
+    }
+
+    root = buildBalanced(nodes, 0, nodes.size());
+}
+
+/**
+ * Resize the Bloom filter and add every bid id in the tree to it again
+ * This also clears the stale bits left behind by removals.
+ *
+ * @param count The number of ids the filter should be sized for
+ */
+void BinarySearchTree::rebuildBloomFilter(size_t count) {
+    bloomFilter.Reset(count, bloomFilter.FalsePositiveRate());
+
+    // Visits every node with an explicit stack so deep trees cannot overflow the call stack
+    vector<Node*> pending;
+    if (root != nullptr) {
+        pending.push_back(root);
+    }
+    while (!pending.empty()) {
+        Node* node = pending.back();
+        pending.pop_back();
+
+        bloomFilter.Add(node->bid.bidId);
+
+        if (node->left != nullptr) {
+            pending.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            pending.push_back(node->right);
+        }
+    }
+}
+
+/**
+ * Add a bid below some node
+ * Walks down with a loop rather than recursion, so a tree built from
+ * sorted input, which is as deep as it is long, cannot overflow the stack.
+ *
+ * @param node Current node in tree
+ * @param bid Bid to be added
+ */
+void BinarySearchTree::addNode(Node* node, Bid bid) {
+    // Traverses the tree until an unoccupied child is found
+    while (true) {
+        // Counts the new node in the size and amount totals of every subtree it is added to
+        node->subtreeSize++;
+        node->amountTotal += bid.amount;
+        node->amountMin = min(node->amountMin, bid.amount);
+        node->amountMax = max(node->amountMax, bid.amount);
+
+        // Checks if the current node's bid id is greater than the passed in bid's id
+        if (node->bid.bidId > bid.bidId) { // Indicates the new bid's id is less than the current node's bid id and needs to be assigne to the left
+            // Checks if the current node's left child is unoccupied
+            if (node->left == nullptr) {
+                // Initializes a new node using the passed in bid and assigns it to the left child node
+                node->left = new Node(bid);
+                return;
+            }
+            // Navigates to the left child
+            node = node->left;
+        }
+        else { // Indicates new bid's id is greater than or equal to the current node's bid id and needs be assigned to the right
+            // Checks if the current node's right child is unoccupied
+            if (node->right == nullptr) {
+                // Initializes a new node using the passed in bid and assigns it to the right child node
+                node->right = new Node(bid);
+                return;
+            }
+            // Navigates to the right child
+            node = node->right;
+        }
+    }
+}
+
+/**
+ * Print a subtree in order, using an explicit stack instead of recursion
+ *
+ * @param node The subtree's root
+ */
+void BinarySearchTree::inOrder(Node* node) {
+    vector<Node*> pending;
+
+    while (node != nullptr || !pending.empty()) {
+        // Descends to the leftmost unvisited node, remembering the path back up
+        while (node != nullptr) {
+            pending.push_back(node);
+            node = node->left;
+        }
+
+        // Visits the node, then continues with its right subtree
+        node = pending.back();
+        pending.pop_back();
+        printNode(node);
+        node = node->right;
+    }
+}
+
+/**
+ * Print a subtree in post-order, using an explicit stack instead of recursion
+ *
+ * @param node The subtree's root
+ */
+void BinarySearchTree::postOrder(Node* node) {
+    vector<Node*> pending;
+    Node* lastVisited = nullptr;
+
+    while (node != nullptr || !pending.empty()) {
+        // Descends to the leftmost unvisited node, remembering the path back up
+        while (node != nullptr) {
+            pending.push_back(node);
+            node = node->left;
+        }
+
+        // Visits a node only once its right subtree is done
+        Node* top = pending.back();
+        if (top->right != nullptr && top->right != lastVisited) {
+            node = top->right;
+        }
+        else {
+            printNode(top);
+            lastVisited = top;
+            pending.pop_back();
+        }
+    }
+}
+
+/**
+ * Print a subtree in pre-order, using an explicit stack instead of recursion
+ *
+ * @param node The subtree's root
+ */
+void BinarySearchTree::preOrder(Node* node) {
+    vector<Node*> pending;
+    if (node != nullptr) {
+        pending.push_back(node);
+    }
+
+    while (!pending.empty()) {
+        node = pending.back();
+        pending.pop_back();
+        printNode(node);
+
+        // Pushes the right child first so the left subtree is visited first
+        if (node->right != nullptr) {
+            pending.push_back(node->right);
+        }
+        if (node->left != nullptr) {
+            pending.push_back(node->left);
+        }
+    }
+}
+
+/**
+ * Remove a bid from below some node
+ * Walks down with a loop, recording the links it passes through, so deep
+ * trees cannot overflow the stack; in balanced mode those links are then
+ * rebalanced from the bottom up.
+ *
+ * @param node The subtree's root
+ * @param bidId The id of the bid to remove
+ * @return The new root of the subtree
+ */
+Node* BinarySearchTree::removeNode(Node* node, string bidId) {
+    // Records each link followed from the subtree's root down to the removed node
+    vector<Node**> path;
+    Node** link = &node;
+
+    // Traverses the tree until the bid id is found or a null value is reached
+    while (*link != nullptr && (*link)->bid.bidId != bidId) {
+        path.push_back(link);
+        // Checks if the current node's bid id is greater than the passed in bidId
+        if ((*link)->bid.bidId > bidId) { // Indicates that the left child needs to be searched
+            link = &(*link)->left;
+        }
+        else { // Indicates that the right child needs to be searched
+            link = &(*link)->right;
+        }
+    }
+
+    // Exits the function as the bid id was not found
+    if (*link == nullptr) {
+        return node;
+    }
+
+    Node* removedNode = *link;
+    // Checks if both children are occupied, in which case the successive node must be removed instead
+    if (removedNode->left != nullptr && removedNode->right != nullptr) {
+        // Traverses to the leftmost node of the right subtree, the successive node
+        path.push_back(link);
+        Node** succLink = &removedNode->right;
+        while ((*succLink)->left != nullptr) {
+            path.push_back(succLink);
+            succLink = &(*succLink)->left;
+        }
+
+        // Moves the successor's bid into the node and unlinks the successor instead
+        Node* succNode = *succLink;
+        removedNode->bid = std::move(succNode->bid);
+        *succLink = succNode->right;
+        freeNode(succNode);
+    }
+    else { // Indicates at most one child is occupied and can take the node's place
+        *link = removedNode->left != nullptr ? removedNode->left : removedNode->right;
+        freeNode(removedNode);
+    }
+
+    // Updates each subtree on the path from the bottom up, rebalancing it when balancing is enabled
+    for (auto pathLink = path.rbegin(); pathLink != path.rend(); ++pathLink) {
+        if (balanced) {
+            **pathLink = rebalance(**pathLink);
+        }
+        else {
+            updateNode(**pathLink);
+        }
+    }
+
+    // Exit the method and return the subtree's root
+    return node;
+}
+
+void BinarySearchTree::printNode(Node* node) {
+    // Initialize a temp var to hold the bid info
+    Bid bid = node->bid;
+    // Display the bid info
+    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+        << bid.fund << endl;
+    // Exit method
+    return;
+}
+
+
+//============================================================================
+// Concurrent-reader binary search tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a binary search tree that one writer thread can change while
+ * any number of reader threads search it without taking locks.
+ *
+ * Child links are atomic and a node's bid never changes once the node is
+ * linked in, so readers always see either the old or the new shape of the
+ * tree. Removal never copies a bid into a node readers may be using; it
+ * links in a fresh node instead. Unlinked nodes are freed with epoch-based
+ * reclamation: each reader announces the epoch it started in, and a node
+ * is only freed two epochs after it was unlinked, once no reader that
+ * could still hold it remains. Insert, Remove and BulkLoad must all be
+ * called from the same writer thread.
+ */
+class ConcurrentBidTree {
+
+private:
+    // Define a structure for nodes whose links readers follow concurrently
+    struct CNode {
+        const Bid bid;
+        atomic<CNode*> left;
+        atomic<CNode*> right;
+
+        CNode(const Bid& aBid) : bid(aBid), left(nullptr), right(nullptr) {
+        }
+    };
+
+    // Define a structure for one reader's announced epoch, 0 while idle,
+    // padded to its own cache line so readers do not falsely share
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{0};
+    };
+
+    // Define a guard that holds a reader slot for the duration of a read
+    class ReadGuard {
+    private:
+        ReaderSlot* slot;
+
+    public:
+        ReadGuard(ConcurrentBidTree& tree);
+        ~ReadGuard();
+    };
+
+    atomic<CNode*> root{nullptr};
+    atomic<size_t> count{0};
+    atomic<uint64_t> globalEpoch{1};
+    ReaderSlot slots[READER_SLOTS];
+
+    // Nodes unlinked by the writer, each with the epoch it was unlinked in
+    vector<pair<uint64_t, CNode*>> retired;
+    atomic<size_t> freedCount{0};
+
+    void retire(CNode* node);
+    void reclaim();
+    void insertMiddles(vector<Bid>& bids, size_t first, size_t last);
+
+public:
+    ConcurrentBidTree();
+    virtual ~ConcurrentBidTree();
+    void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
+    void Remove(const string& bidId);
+    Bid Search(const string& bidId);
+    void InOrder();
+    size_t Size();
+    size_t FreedNodes();
+};
+
+/**
+ * Claim a free reader slot and announce the current epoch in it
+ */
+ConcurrentBidTree::ReadGuard::ReadGuard(ConcurrentBidTree& tree) {
+    // Starts each thread at its own slot so threads rarely compete for one
+    static thread_local size_t start = hash<thread::id>()(this_thread::get_id());
+
+    for (size_t i = start;; i++) {
+        ReaderSlot& candidate = tree.slots[i % READER_SLOTS];
+        uint64_t idle = 0;
+        if (candidate.epoch.compare_exchange_strong(idle, tree.globalEpoch.load())) {
+            slot = &candidate;
+            return;
+        }
+    }
+}
+
+/**
+ * Release the reader slot, marking the reader idle
+ */
+ConcurrentBidTree::ReadGuard::~ReadGuard() {
+    slot->epoch.store(0);
+}
+
+/**
+ * Default constructor
+ */
+ConcurrentBidTree::ConcurrentBidTree() {
+}
+
+/**
+ * Destructor, which must run once no reader is left
+ */
+ConcurrentBidTree::~ConcurrentBidTree() {
+    // Frees every linked node with an explicit stack
+    vector<CNode*> pending;
+    if (root.load() != nullptr) {
+        pending.push_back(root.load());
+    }
+    while (!pending.empty()) {
+        CNode* node = pending.back();
+        pending.pop_back();
+        if (node->left.load() != nullptr) {
+            pending.push_back(node->left.load());
+        }
+        if (node->right.load() != nullptr) {
+            pending.push_back(node->right.load());
+        }
+        delete node;
+    }
+
+    // Frees the nodes still waiting out their epochs
+    for (auto& entry : retired) {
+        delete entry.second;
+    }
+}
+
+/**
+ * Queue an unlinked node to be freed once no reader can still hold it
+ */
+void ConcurrentBidTree::retire(CNode* node) {
+    retired.push_back(make_pair(globalEpoch.load(), node));
+    if (retired.size() >= RECLAIM_THRESHOLD) {
+        reclaim();
+    }
+}
+
+/**
+ * Advance the epoch if every active reader has caught up with it, then
+ * free the nodes unlinked at least two epochs ago
+ */
+void ConcurrentBidTree::reclaim() {
+    uint64_t epoch = globalEpoch.load();
+    bool caughtUp = true;
+    for (ReaderSlot& slot : slots) {
+        uint64_t readerEpoch = slot.epoch.load();
+        if (readerEpoch != 0 && readerEpoch != epoch) {
+            caughtUp = false;
+            break;
+        }
+    }
+    if (caughtUp) {
+        globalEpoch.store(++epoch);
+    }
+
+    // Frees the old enough nodes and keeps the rest, in retirement order
+    size_t kept = 0;
+    for (auto& entry : retired) {
+        if (entry.first + 2 <= epoch) {
+            delete entry.second;
+            freedCount++;
+        }
+        else {
+            retired[kept++] = entry;
+        }
+    }
+    retired.resize(kept);
+}
+
+/**
+ * Insert a bid (writer thread only)
+ */
+void ConcurrentBidTree::Insert(Bid bid) {
+    // Fills the node completely before the release store that publishes it
+    CNode* node = new CNode(bid);
+
+    // Finds the empty link the node belongs at, equal ids go to the right
+    atomic<CNode*>* link = &root;
+    while (link->load(memory_order_relaxed) != nullptr) {
+        CNode* currNode = link->load(memory_order_relaxed);
+        link = currNode->bid.bidId > bid.bidId ? &currNode->left : &currNode->right;
+    }
+    link->store(node, memory_order_release);
+    count++;
+}
+
+/**
+ * Add many bids, inserting each range's middle bid first so sorted input
+ * yields a balanced tree (writer thread only)
+ *
+ * @param bids The bids to add
+ */
+void ConcurrentBidTree::BulkLoad(vector<Bid> bids) {
+    auto byId = [](const Bid& a, const Bid& b) { return a.bidId < b.bidId; };
+    if (!is_sorted(bids.begin(), bids.end(), byId)) {
+        stable_sort(bids.begin(), bids.end(), byId);
+    }
+    insertMiddles(bids, 0, bids.size());
+}
+
+/**
+ * Insert a sorted range of bids, middle first (recursive, the depth is log n)
+ */
+void ConcurrentBidTree::insertMiddles(vector<Bid>& bids, size_t first, size_t last) {
+    if (first >= last) {
+        return;
+    }
+
+    size_t middle = first + (last - first) / 2;
+    Insert(bids[middle]);
+    insertMiddles(bids, first, middle);
+    insertMiddles(bids, middle + 1, last);
+}
+
+/**
+ * Remove a bid (writer thread only)
+ * A node with two children is replaced by a new node holding its
+ * successor's bid; the successor is unlinked only after the new node is
+ * visible, so a concurrent reader can always find the successor's id.
+ *
+ * @param bidId The id of the bid to remove
+ */
+void ConcurrentBidTree::Remove(const string& bidId) {
+    // Finds the link pointing at the node to remove
+    atomic<CNode*>* link = &root;
+    CNode* removedNode = link->load(memory_order_relaxed);
+    while (removedNode != nullptr && removedNode->bid.bidId != bidId) {
+        link = removedNode->bid.bidId > bidId ? &removedNode->left : &removedNode->right;
+        removedNode = link->load(memory_order_relaxed);
+    }
+    if (removedNode == nullptr) {
+        return;
+    }
+
+    CNode* left = removedNode->left.load(memory_order_relaxed);
+    CNode* right = removedNode->right.load(memory_order_relaxed);
+
+    // Checks if at most one child is occupied, which then takes the node's place
+    if (left == nullptr || right == nullptr) {
+        link->store(left != nullptr ? left : right, memory_order_release);
+        retire(removedNode);
+        count--;
+        return;
+    }
+
+    // Finds the successor, the leftmost node of the right subtree, and the link to it
+    atomic<CNode*>* succLink = &removedNode->right;
+    CNode* succNode = right;
+    while (succNode->left.load(memory_order_relaxed) != nullptr) {
+        succLink = &succNode->left;
+        succNode = succNode->left.load(memory_order_relaxed);
+    }
+
+    // Builds the replacement, skipping over the successor if it is the right child itself
+    CNode* replacement = new CNode(succNode->bid);
+    replacement->left.store(left, memory_order_relaxed);
+    replacement->right.store(succNode == right ? succNode->right.load(memory_order_relaxed) : right,
+        memory_order_relaxed);
+    link->store(replacement, memory_order_release);
+
+    // Unlinks the successor from its old place, now that its bid is also in the replacement
+    if (succNode != right) {
+        succLink->store(succNode->right.load(memory_order_relaxed), memory_order_release);
+    }
+
+    retire(removedNode);
+    retire(succNode);
+    count--;
+}
+
+/**
+ * Search for a bid (any thread, never blocks the writer)
+ *
+ * @param bidId The id to look up
+ * @return A copy of the bid, or an empty bid if the id is not in the tree
+ */
+Bid ConcurrentBidTree::Search(const string& bidId) {
+    ReadGuard guard(*this);
+
+    CNode* currNode = root.load(memory_order_acquire);
+    while (currNode != nullptr) {
+        if (currNode->bid.bidId == bidId) {
+            return currNode->bid;
+        }
+        currNode = (currNode->bid.bidId > bidId ? currNode->left : currNode->right).load(memory_order_acquire);
+    }
+
+    return Bid();
+}
+
+/**
+ * Traverse the tree in order (any thread)
+ */
+void ConcurrentBidTree::InOrder() {
+    ReadGuard guard(*this);
+
+    vector<CNode*> pending;
+    CNode* node = root.load(memory_order_acquire);
+    while (node != nullptr || !pending.empty()) {
+        while (node != nullptr) {
+            pending.push_back(node);
+            node = node->left.load(memory_order_acquire);
+        }
+
+        node = pending.back();
+        pending.pop_back();
+        cout << node->bid.bidId << ": " << node->bid.title << " | " << node->bid.amount << " | "
+            << node->bid.fund << endl;
+        node = node->right.load(memory_order_acquire);
+    }
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+size_t ConcurrentBidTree::Size() {
+    return count.load();
+}
+
+/**
+ * Returns the number of removed nodes freed so far
+ */
+size_t ConcurrentBidTree::FreedNodes() {
+    return freedCount.load();
+}
+
+//============================================================================
+// Integer-keyed bid tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a balanced bid tree that stores numeric bid ids as integers.
+ *
+ * Both maps are the shared OrderedMap engine. Ids made only of digits, with
+ * no leading zero and at most 18 of them, are kept as 64-bit integers, so
+ * each comparison on the way down is one instruction and no string data is
+ * read. Any other id falls back to a map keyed by the id string. InOrder
+ * lists the numeric ids in numeric order, then the others; for the CSV
+ * files, whose ids all have five digits, that is the same order as InOrder
+ * on BinarySearchTree.
+ */
+class NumericBidTree {
+
+private:
+    OrderedMap<uint64_t, Bid> numericBids;
+    OrderedMap<string, Bid> otherBids;
+
+    static bool toNumber(const string& bidId, uint64_t& number);
+
+public:
+    void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    void InOrder();
+    size_t Size();
+    int Height();
+};
+
+/**
+ * Convert a bid id to the integer it is stored under
+ *
+ * @param bidId The bid id
+ * @param number Set to the id's value when it converts
+ * @return False if the id must be stored as a string instead
+ */
+bool NumericBidTree::toNumber(const string& bidId, uint64_t& number) {
+    // Rejects ids that would collide with another spelling of the same number or overflow
+    if (bidId.empty() || bidId.size() > 18 || (bidId[0] == '0' && bidId.size() > 1)) {
+        return false;
+    }
+
+    number = 0;
+    for (char c : bidId) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        number = number * 10 + static_cast<uint64_t>(c - '0');
+    }
+    return true;
+}
+
+/**
+ * Insert a bid, replacing any bid with the same id
+ */
+void NumericBidTree::Insert(Bid bid) {
+    uint64_t number;
+    if (toNumber(bid.bidId, number)) {
+        numericBids.Insert(number, std::move(bid));
+    }
+    else {
+        string bidId = bid.bidId;
+        otherBids.Insert(std::move(bidId), std::move(bid));
+    }
+}
+
+/**
+ * Add many bids at once
+ */
+void NumericBidTree::BulkLoad(vector<Bid> bids) {
+    for (Bid& bid : bids) {
+        Insert(std::move(bid));
+    }
+}
+
+/**
+ * Remove a bid
+ */
+void NumericBidTree::Remove(string bidId) {
+    uint64_t number;
+    if (toNumber(bidId, number)) {
+        numericBids.Remove(number);
+    }
+    else {
+        otherBids.Remove(bidId);
+    }
+}
+
+/**
+ * Search for a bid
+ */
+Bid NumericBidTree::Search(string bidId) {
+    uint64_t number;
+    const Bid* bid = toNumber(bidId, number) ? numericBids.Find(number) : otherBids.Find(bidId);
+
+    // Returns an empty bid, indicating the bid id is not in the tree, if nothing was found
+    return bid != nullptr ? *bid : Bid();
+}
+
+/**
+ * Traverse the bids in order, the numeric ids first
+ */
+void NumericBidTree::InOrder() {
+    auto print = [](const auto&, const Bid& bid) {
+        cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+            << bid.fund << endl;
+    };
+    numericBids.ForEach(print);
+    otherBids.ForEach(print);
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+size_t NumericBidTree::Size() {
+    return numericBids.Size() + otherBids.Size();
+}
+
+/**
+ * Returns the number of levels in the taller of the two maps
+ */
+int NumericBidTree::Height() {
+    return max(numericBids.Height(), otherBids.Height());
+}
+
+//============================================================================
+// Persistent binary search tree class definitions
+//============================================================================
+
+// Define a structure for the nodes of a persistent tree, never changed once
+// built and shared between every version of the tree that reaches them
+struct PersistentNode {
+    const Bid bid;
+    const shared_ptr<const PersistentNode> left;
+    const shared_ptr<const PersistentNode> right;
+    const int height;
+
+    PersistentNode(const Bid& aBid, shared_ptr<const PersistentNode> aLeft, shared_ptr<const PersistentNode> aRight) :
+            bid(aBid), left(std::move(aLeft)), right(std::move(aRight)),
+            height(1 + max(left ? left->height : 0, right ? right->height : 0)) {
+    }
+};
+
+/**
+ * Define a class containing a read-only view of a PersistentBidTree as it
+ * was when the snapshot was taken.
+ *
+ * A snapshot holds a reference to one version's root and nothing else, so
+ * taking or copying one is O(1), and later edits to the tree never change
+ * what it sees. The nodes are immutable and reference-counted atomically,
+ * so a snapshot can be read on another thread while the tree is edited.
+ */
+class BidTreeSnapshot {
+
+private:
+    shared_ptr<const PersistentNode> root;
+    size_t size = 0;
+
+    friend class PersistentBidTree;
+
+public:
+    Bid Search(const string& bidId) const;
+    void InOrder() const;
+    size_t Size() const;
+};
+
+/**
+ * Search the snapshot for a bid
+ */
+Bid BidTreeSnapshot::Search(const string& bidId) const {
+    const PersistentNode* node = root.get();
+    while (node != nullptr) {
+        if (node->bid.bidId == bidId) {
+            return node->bid;
+        }
+        node = (node->bid.bidId > bidId ? node->left : node->right).get();
+    }
+    return Bid();
+}
+
+/**
+ * Traverse the snapshot's bids in order
+ */
+void BidTreeSnapshot::InOrder() const {
+    vector<const PersistentNode*> pending;
+    const PersistentNode* node = root.get();
+    while (node != nullptr || !pending.empty()) {
+        while (node != nullptr) {
+            pending.push_back(node);
+            node = node->left.get();
+        }
+        node = pending.back();
+        pending.pop_back();
+        cout << node->bid.bidId << ": " << node->bid.title << " | " << node->bid.amount << " | "
+            << node->bid.fund << endl;
+        node = node->right.get();
+    }
+}
+
+/**
+ * Returns the number of bids in the snapshot
+ */
+size_t BidTreeSnapshot::Size() const {
+    return size;
+}
+
+/**
+ * Define a class containing data members and methods to
+ * implement a persistent, AVL-balanced binary search tree of bids.
+ *
+ * Insert and Remove never change a node: they build new copies of the
+ * O(log n) nodes on the path to the change and share every other subtree
+ * with the previous version. Snapshot() hands out the current version in
+ * O(1), and a version's nodes are freed when the last tree or snapshot
+ * referring to them lets go. Bid ids are unique: inserting an existing id
+ * replaces its bid.
+ */
+class PersistentBidTree {
+
+private:
+    typedef shared_ptr<const PersistentNode> Link;
+
+    BidTreeSnapshot current;
+
+    static int height(const Link& node);
+    static Link makeNode(const Bid& bid, Link left, Link right);
+    static Link balance(const Bid& bid, Link left, Link right);
+    static Link insertInto(const Link& node, const Bid& bid, bool& added);
+    static Link removeFrom(const Link& node, const string& bidId, bool& removed);
+    static Link removeMin(const Link& node, Bid& minBid);
+    static Link buildFromSorted(vector<Bid>& bids, size_t first, size_t last);
+
+public:
+    void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    void InOrder();
+    BidTreeSnapshot Snapshot();
+    size_t Size();
+    int Height();
+};
+
+/**
+ * Returns the height of a subtree, zero for an empty one
+ */
+int PersistentBidTree::height(const Link& node) {
+    return node ? node->height : 0;
+}
+
+/**
+ * Build a new node over two existing subtrees
+ */
+PersistentBidTree::Link PersistentBidTree::makeNode(const Bid& bid, Link left, Link right) {
+    return make_shared<const PersistentNode>(bid, std::move(left), std::move(right));
+}
+
+/**
+ * Build a new node over two subtrees whose heights differ by at most two,
+ * rotating through copies of the taller side's top nodes if needed
+ *
+ * @return The root of the balanced subtree
+ */
+PersistentBidTree::Link PersistentBidTree::balance(const Bid& bid, Link left, Link right) {
+    int leftHeight = height(left);
+    int rightHeight = height(right);
+
+    // Checks if the left side is two levels taller, rotating right (or left-right)
+    if (leftHeight > rightHeight + 1) {
+        if (height(left->left) >= height(left->right)) {
+            return makeNode(left->bid, left->left, makeNode(bid, left->right, std::move(right)));
+        }
+        const Link& inner = left->right;
+        return makeNode(inner->bid, makeNode(left->bid, left->left, inner->left),
+            makeNode(bid, inner->right, std::move(right)));
+    }
+
+    // Checks if the right side is two levels taller, rotating left (or right-left)
+    if (rightHeight > leftHeight + 1) {
+        if (height(right->right) >= height(right->left)) {
+            return makeNode(right->bid, makeNode(bid, std::move(left), right->left), right->right);
+        }
+        const Link& inner = right->left;
+        return makeNode(inner->bid, makeNode(bid, std::move(left), inner->left),
+            makeNode(right->bid, inner->right, right->right));
+    }
+
+    return makeNode(bid, std::move(left), std::move(right));
+}
+
+/**
+ * Build the new version of a subtree with a bid added (recursive, the depth is log n)
+ *
+ * @param added Set to true if the id was not already in the subtree
+ * @return The new subtree's root
+ */
+PersistentBidTree::Link PersistentBidTree::insertInto(const Link& node, const Bid& bid, bool& added) {
+    if (!node) {
+        added = true;
+        return makeNode(bid, nullptr, nullptr);
+    }
+
+    if (bid.bidId < node->bid.bidId) {
+        return balance(node->bid, insertInto(node->left, bid, added), node->right);
+    }
+    if (node->bid.bidId < bid.bidId) {
+        return balance(node->bid, node->left, insertInto(node->right, bid, added));
+    }
+    return makeNode(bid, node->left, node->right);
+}
+
+/**
+ * Build the new version of a subtree without its smallest bid (recursive)
+ *
+ * @param minBid Set to the smallest bid
+ * @return The new subtree's root
+ */
+PersistentBidTree::Link PersistentBidTree::removeMin(const Link& node, Bid& minBid) {
+    if (!node->left) {
+        minBid = node->bid;
+        return node->right;
+    }
+    return balance(node->bid, removeMin(node->left, minBid), node->right);
+}
+
+/**
+ * Build the new version of a subtree without a bid (recursive, the depth is log n)
+ * A subtree that does not hold the id is returned as it is, without copying.
+ *
+ * @param removed Set to true if the id was found
+ * @return The new subtree's root
+ */
+PersistentBidTree::Link PersistentBidTree::removeFrom(const Link& node, const string& bidId, bool& removed) {
+    if (!node) {
+        return node;
+    }
+
+    if (bidId < node->bid.bidId) {
+        Link left = removeFrom(node->left, bidId, removed);
+        return removed ? balance(node->bid, std::move(left), node->right) : node;
+    }
+    if (node->bid.bidId < bidId) {
+        Link right = removeFrom(node->right, bidId, removed);
+        return removed ? balance(node->bid, node->left, std::move(right)) : node;
+    }
+
+    // Replaces the node with its successor, or with its only child
+    removed = true;
+    if (!node->left || !node->right) {
+        return node->left ? node->left : node->right;
+    }
+    Bid successor;
+    Link right = removeMin(node->right, successor);
+    return balance(successor, node->left, std::move(right));
+}
+
+/**
+ * Build a perfectly balanced subtree from a sorted range of bids (recursive)
+ */
+PersistentBidTree::Link PersistentBidTree::buildFromSorted(vector<Bid>& bids, size_t first, size_t last) {
+    if (first >= last) {
+        return nullptr;
+    }
+
+    size_t middle = first + (last - first) / 2;
+    Link left = buildFromSorted(bids, first, middle);
+    Link right = buildFromSorted(bids, middle + 1, last);
+    return makeNode(bids[middle], std::move(left), std::move(right));
+}
+
+/**
+ * Insert a bid, replacing any bid with the same id
+ */
+void PersistentBidTree::Insert(Bid bid) {
+    bool added = false;
+    current.root = insertInto(current.root, bid, added);
+    if (added) {
+        current.size++;
+    }
+}
+
+/**
+ * Add many bids at once
+ * An empty tree is built balanced from the sorted bids in linear time;
+ * otherwise each bid is inserted in turn.
+ *
+ * @param bids The bids to add
+ */
+void PersistentBidTree::BulkLoad(vector<Bid> bids) {
+    auto byId = [](const Bid& a, const Bid& b) { return a.bidId < b.bidId; };
+    if (!is_sorted(bids.begin(), bids.end(), byId)) {
+        stable_sort(bids.begin(), bids.end(), byId);
+    }
+
+    // Inserts one at a time when ids repeat, so the last bid of each id wins as with Insert
+    bool unique = adjacent_find(bids.begin(), bids.end(),
+        [](const Bid& a, const Bid& b) { return a.bidId == b.bidId; }) == bids.end();
+
+    if (current.root || !unique) {
+        for (Bid& bid : bids) {
+            Insert(std::move(bid));
+        }
+        return;
+    }
+
+    current.root = buildFromSorted(bids, 0, bids.size());
+    current.size = bids.size();
+}
+
+/**
+ * Remove a bid
+ */
+void PersistentBidTree::Remove(string bidId) {
+    bool removed = false;
+    current.root = removeFrom(current.root, bidId, removed);
+    if (removed) {
+        current.size--;
+    }
+}
+
+/**
+ * Search for a bid in the current version
+ */
+Bid PersistentBidTree::Search(string bidId) {
+    return current.Search(bidId);
+}
+
+/**
+ * Traverse the current version's bids in order
+ */
+void PersistentBidTree::InOrder() {
+    current.InOrder();
+}
+
+/**
+ * Returns a read-only snapshot of the current version in O(1)
+ */
+BidTreeSnapshot PersistentBidTree::Snapshot() {
+    return current;
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+size_t PersistentBidTree::Size() {
+    return current.size;
+}
+
+/**
+ * Returns the number of levels in the tree
+ */
+int PersistentBidTree::Height() {
+    return height(current.root);
+}
+
+//============================================================================
+// Adaptive radix tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement an adaptive radix tree (ART) of bids keyed by the bytes of the bid id.
+ *
+ * Each inner node branches on one byte of the id and picks the smallest of
+ * four layouts that fits its children: Node4 and Node16 keep sorted byte
+ * arrays, Node48 maps all 256 bytes to 48 child slots, and Node256 indexes
+ * its children directly. Chains of single-child nodes are compressed into a
+ * node's prefix, of which the first MAX_PREFIX bytes are stored; longer
+ * prefixes are skipped during a search and confirmed at the leaf. A leaf is
+ * created as soon as an id's path is unique, so a lookup of a five-digit id
+ * touches only a few nodes and compares no strings until the leaf. Ids are
+ * treated as ending in a zero byte, so they must not contain one; this
+ * keeps "98" and "980" apart and orders them as strings are ordered. Bid
+ * ids are unique: inserting an existing id replaces its bid.
+ */
+class RadixBidIndex {
+
+private:
+    static const unsigned int MAX_PREFIX = 8;
+
+    enum NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+    // Define the fields shared by every inner node layout
+    struct ArtNode {
+        NodeType type;
+        uint16_t count = 0;
+        uint32_t prefixLength = 0;
+        uint8_t prefix[MAX_PREFIX];
+
+        ArtNode(NodeType nodeType) {
+            type = nodeType;
+        }
+    };
+
+    // Define the four inner node layouts, from the smallest to the largest
+    struct Node4 : ArtNode {
+        uint8_t keys[4];
+        ArtNode* children[4];
+        Node4() : ArtNode(NODE4) {
+        }
+    };
+
+    struct Node16 : ArtNode {
+        uint8_t keys[16];
+        ArtNode* children[16];
+        Node16() : ArtNode(NODE16) {
+        }
+    };
+
+    struct Node48 : ArtNode {
+        // slot + 1 of each byte's child, 0 when the byte has none
+        uint8_t childIndex[256] = {};
+        ArtNode* children[48] = {};
+        Node48() : ArtNode(NODE48) {
+        }
+    };
+
+    struct Node256 : ArtNode {
+        ArtNode* children[256] = {};
+        Node256() : ArtNode(NODE256) {
+        }
+    };
+
+    // Define a structure for the leaves, stored in child slots with the low pointer bit set
+    struct ArtLeaf {
+        Bid bid;
+        ArtLeaf(Bid aBid) : bid(std::move(aBid)) {
+        }
+    };
+
+    ArtNode* root = nullptr;
+    size_t size = 0;
+    size_t bytesUsed = 0;
+
+    static bool isLeaf(const ArtNode* node);
+    static ArtLeaf* asLeaf(const ArtNode* node);
+    static ArtNode* tagLeaf(ArtLeaf* leaf);
+    static uint8_t keyByte(const string& key, size_t depth);
+    static unsigned int lowestBit(unsigned int mask);
+    static ArtLeaf* minimum(const ArtNode* node);
+    static ArtNode** findChild(ArtNode* node, uint8_t byte);
+    static size_t prefixMismatch(const ArtNode* node, const string& key, size_t depth);
+    ArtNode* newLeaf(Bid& bid);
+    template <typename Layout> Layout* newNode(const ArtNode* header);
+    void freeNode(ArtNode* node);
+    void destroy(ArtNode* node);
+    void addChild(ArtNode** slot, uint8_t byte, ArtNode* child);
+    void removeChild(ArtNode** slot, uint8_t byte);
+    void insertAt(ArtNode** slot, Bid& bid, size_t depth);
+    bool removeAt(ArtNode** slot, const string& bidId, size_t depth);
+    template <typename Visit> static void forEach(const ArtNode* node, Visit& visit);
+
+public:
+    RadixBidIndex();
+    virtual ~RadixBidIndex();
+    void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    void InOrder();
+    vector<Bid> PrefixScan(const string& prefix);
+    size_t Size();
+    size_t MemoryUsage();
+};
+
+// Definition for the class constant, needed when it is bound to a reference
+const unsigned int RadixBidIndex::MAX_PREFIX;
+
+/**
+ * Default constructor
+ */
+RadixBidIndex::RadixBidIndex() {
+}
+
+/**
+ * Destructor
+ */
+RadixBidIndex::~RadixBidIndex() {
+    destroy(root);
+}
+
+/**
+ * Returns true if a child slot holds a leaf rather than an inner node
+ */
+bool RadixBidIndex::isLeaf(const ArtNode* node) {
+    return (reinterpret_cast<uintptr_t>(node) & 1) != 0;
+}
+
+/**
+ * Returns the leaf a tagged child slot points to
+ */
+RadixBidIndex::ArtLeaf* RadixBidIndex::asLeaf(const ArtNode* node) {
+    return reinterpret_cast<ArtLeaf*>(reinterpret_cast<uintptr_t>(node) & ~static_cast<uintptr_t>(1));
+}
+
+/**
+ * Returns a leaf pointer tagged for storing in a child slot
+ */
+RadixBidIndex::ArtNode* RadixBidIndex::tagLeaf(ArtLeaf* leaf) {
+    return reinterpret_cast<ArtNode*>(reinterpret_cast<uintptr_t>(leaf) | 1);
+}
+
+/**
+ * Returns the key's byte at a depth, the terminating zero byte past its end
+ */
+uint8_t RadixBidIndex::keyByte(const string& key, size_t depth) {
+    return depth < key.size() ? static_cast<uint8_t>(key[depth]) : 0;
+}
+
+/**
+ * Returns the position of the lowest set bit of a non-zero mask
+ */
+unsigned int RadixBidIndex::lowestBit(unsigned int mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    unsigned int index = 0;
+    while ((mask & 1u) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+/**
+ * Returns the leaf with the smallest id below a node
+ */
+RadixBidIndex::ArtLeaf* RadixBidIndex::minimum(const ArtNode* node) {
+    while (!isLeaf(node)) {
+        switch (node->type) {
+        case NODE4:
+            node = static_cast<const Node4*>(node)->children[0];
+            break;
+        case NODE16:
+            node = static_cast<const Node16*>(node)->children[0];
+            break;
+        case NODE48: {
+            const Node48* node48 = static_cast<const Node48*>(node);
+            unsigned int byte = 0;
+            while (node48->childIndex[byte] == 0) {
+                byte++;
+            }
+            node = node48->children[node48->childIndex[byte] - 1];
+            break;
+        }
+        case NODE256: {
+            const Node256* node256 = static_cast<const Node256*>(node);
+            unsigned int byte = 0;
+            while (node256->children[byte] == nullptr) {
+                byte++;
+            }
+            node = node256->children[byte];
+            break;
+        }
+        }
+    }
+    return asLeaf(node);
+}
+
+/**
+ * Find the child slot of an inner node for a byte
+ *
+ * @return The slot, or null if the node has no child for the byte
+ */
+RadixBidIndex::ArtNode** RadixBidIndex::findChild(ArtNode* node, uint8_t byte) {
+    switch (node->type) {
+    case NODE4: {
+        Node4* node4 = static_cast<Node4*>(node);
+        for (unsigned int i = 0; i < node4->count; i++) {
+            if (node4->keys[i] == byte) {
+                return &node4->children[i];
+            }
+        }
+        return nullptr;
+    }
+    case NODE16: {
+        Node16* node16 = static_cast<Node16*>(node);
+#ifdef ART_SSE2
+        // Compares the byte against all sixteen keys at once
+        __m128i match = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(node16->keys)));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(match)) & ((1u << node16->count) - 1);
+        return mask != 0 ? &node16->children[lowestBit(mask)] : nullptr;
+#else
+        for (unsigned int i = 0; i < node16->count; i++) {
+            if (node16->keys[i] == byte) {
+                return &node16->children[i];
+            }
+        }
+        return nullptr;
+#endif
+    }
+    case NODE48: {
+        Node48* node48 = static_cast<Node48*>(node);
+        uint8_t index = node48->childIndex[byte];
+        return index != 0 ? &node48->children[index - 1] : nullptr;
+    }
+    case NODE256: {
+        Node256* node256 = static_cast<Node256*>(node);
+        return node256->children[byte] != nullptr ? &node256->children[byte] : nullptr;
+    }
+    }
+    return nullptr;
+}
+
+/**
+ * Count how many bytes of a node's prefix match a key from some depth
+ * Bytes beyond the stored MAX_PREFIX are read from the subtree's smallest
+ * leaf, as every id below the node shares the whole prefix.
+ */
+size_t RadixBidIndex::prefixMismatch(const ArtNode* node, const string& key, size_t depth) {
+    size_t stored = min<size_t>(node->prefixLength, MAX_PREFIX);
+    size_t i = 0;
+    while (i < stored && node->prefix[i] == keyByte(key, depth + i)) {
+        i++;
+    }
+    if (i < stored || node->prefixLength <= MAX_PREFIX) {
+        return i;
+    }
+
+    const string& minKey = minimum(node)->bid.bidId;
+    while (i < node->prefixLength && keyByte(minKey, depth + i) == keyByte(key, depth + i)) {
+        i++;
+    }
+    return i;
+}
+
+/**
+ * Allocate a leaf for a bid and return it tagged
+ */
+RadixBidIndex::ArtNode* RadixBidIndex::newLeaf(Bid& bid) {
+    bytesUsed += sizeof(ArtLeaf);
+    size++;
+    return tagLeaf(new ArtLeaf(std::move(bid)));
+}
+
+/**
+ * Allocate an inner node, copying the prefix from another node if given
+ */
+template <typename Layout>
+Layout* RadixBidIndex::newNode(const ArtNode* header) {
+    Layout* node = new Layout();
+    bytesUsed += sizeof(Layout);
+    if (header != nullptr) {
+        node->prefixLength = header->prefixLength;
+        memcpy(node->prefix, header->prefix, MAX_PREFIX);
+    }
+    return node;
+}
+
+/**
+ * Free a single inner node or leaf, leaving its children alone
+ */
+void RadixBidIndex::freeNode(ArtNode* node) {
+    if (isLeaf(node)) {
+        bytesUsed -= sizeof(ArtLeaf);
+        size--;
+        delete asLeaf(node);
+        return;
+    }
+
+    switch (node->type) {
+    case NODE4:
+        bytesUsed -= sizeof(Node4);
+        delete static_cast<Node4*>(node);
+        break;
+    case NODE16:
+        bytesUsed -= sizeof(Node16);
+        delete static_cast<Node16*>(node);
+        break;
+    case NODE48:
+        bytesUsed -= sizeof(Node48);
+        delete static_cast<Node48*>(node);
+        break;
+    case NODE256:
+        bytesUsed -= sizeof(Node256);
+        delete static_cast<Node256*>(node);
+        break;
+    }
+}
+
+/**
+ * Free a subtree (recursive, the depth is bounded by the id length)
+ */
+void RadixBidIndex::destroy(ArtNode* node) {
+    if (node == nullptr) {
+        return;
+    }
+    if (!isLeaf(node)) {
+        switch (node->type) {
+        case NODE4:
+            for (unsigned int i = 0; i < node->count; i++) {
+                destroy(static_cast<Node4*>(node)->children[i]);
+            }
+            break;
+        case NODE16:
+            for (unsigned int i = 0; i < node->count; i++) {
+                destroy(static_cast<Node16*>(node)->children[i]);
+            }
+            break;
+        case NODE48:
+            for (unsigned int i = 0; i < 48; i++) {
+                destroy(static_cast<Node48*>(node)->children[i]);
+            }
+            break;
+        case NODE256:
+            for (unsigned int i = 0; i < 256; i++) {
+                destroy(static_cast<Node256*>(node)->children[i]);
+            }
+            break;
+        }
+    }
+    freeNode(node);
+}
+
+/**
+ * Add a child to the inner node in a slot, growing the node into the next
+ * larger layout first if it is full
+ *
+ * @param slot The slot holding the node, updated if the node is replaced
+ * @param byte The byte the child is reached by
+ * @param child The child node or tagged leaf
+ */
+void RadixBidIndex::addChild(ArtNode** slot, uint8_t byte, ArtNode* child) {
+    ArtNode* node = *slot;
+
+    switch (node->type) {
+    case NODE4: {
+        Node4* node4 = static_cast<Node4*>(node);
+        if (node4->count < 4) {
+            // Keeps the keys sorted so iteration visits the children in order
+            unsigned int index = 0;
+            while (index < node4->count && node4->keys[index] < byte) {
+                index++;
+            }
+            memmove(node4->keys + index + 1, node4->keys + index, node4->count - index);
+            memmove(node4->children + index + 1, node4->children + index, (node4->count - index) * sizeof(ArtNode*));
+            node4->keys[index] = byte;
+            node4->children[index] = child;
+            node4->count++;
+            return;
+        }
+
+        Node16* grown = newNode<Node16>(node4);
+        memcpy(grown->keys, node4->keys, 4);
+        memcpy(grown->children, node4->children, 4 * sizeof(ArtNode*));
+        grown->count = 4;
+        *slot = grown;
+        freeNode(node4);
+        break;
+    }
+    case NODE16: {
+        Node16* node16 = static_cast<Node16*>(node);
+        if (node16->count < 16) {
+            unsigned int index = 0;
+            while (index < node16->count && node16->keys[index] < byte) {
+                index++;
+            }
+            memmove(node16->keys + index + 1, node16->keys + index, node16->count - index);
+            memmove(node16->children + index + 1, node16->children + index, (node16->count - index) * sizeof(ArtNode*));
+            node16->keys[index] = byte;
+            node16->children[index] = child;
+            node16->count++;
+            return;
+        }
+
+        Node48* grown = newNode<Node48>(node16);
+        for (unsigned int i = 0; i < 16; i++) {
+            grown->childIndex[node16->keys[i]] = static_cast<uint8_t>(i + 1);
+            grown->children[i] = node16->children[i];
+        }
+        grown->count = 16;
+        *slot = grown;
+        freeNode(node16);
+        break;
+    }
+    case NODE48: {
+        Node48* node48 = static_cast<Node48*>(node);
+        if (node48->count < 48) {
+            // Takes the first free child slot, removals may have left gaps
+            unsigned int index = 0;
+            while (node48->children[index] != nullptr) {
+                index++;
+            }
+            node48->children[index] = child;
+            node48->childIndex[byte] = static_cast<uint8_t>(index + 1);
+            node48->count++;
+            return;
+        }
+
+        Node256* grown = newNode<Node256>(node48);
+        for (unsigned int b = 0; b < 256; b++) {
+            if (node48->childIndex[b] != 0) {
+                grown->children[b] = node48->children[node48->childIndex[b] - 1];
+            }
+        }
+        grown->count = 48;
+        *slot = grown;
+        freeNode(node48);
+        break;
+    }
+    case NODE256: {
+        Node256* node256 = static_cast<Node256*>(node);
+        node256->children[byte] = child;
+        node256->count++;
+        return;
+    }
+    }
+
+    // Adds the child to the grown node
+    addChild(slot, byte, child);
+}
+
+/**
+ * Remove a child from the inner node in a slot, shrinking the node into
+ * the next smaller layout once it is sparse enough, and merging a Node4
+ * left with one child into that child
+ *
+ * @param slot The slot holding the node, updated if the node is replaced
+ * @param byte The byte of the child to remove
+ */
+void RadixBidIndex::removeChild(ArtNode** slot, uint8_t byte) {
+    ArtNode* node = *slot;
+
+    switch (node->type) {
+    case NODE4: {
+        Node4* node4 = static_cast<Node4*>(node);
+        unsigned int index = 0;
+        while (node4->keys[index] != byte) {
+            index++;
+        }
+        memmove(node4->keys + index, node4->keys + index + 1, node4->count - index - 1);
+        memmove(node4->children + index, node4->children + index + 1, (node4->count - index - 1) * sizeof(ArtNode*));
+        node4->count--;
+        if (node4->count > 1) {
+            return;
+        }
+
+        // Replaces the node with its only child, prepending the node's prefix and byte to the child's
+        ArtNode* child = node4->children[0];
+        if (!isLeaf(child)) {
+            uint32_t length = node4->prefixLength;
+            if (length < MAX_PREFIX) {
+                node4->prefix[length++] = node4->keys[0];
+            }
+            if (length < MAX_PREFIX) {
+                memcpy(node4->prefix + length, child->prefix, min<size_t>(child->prefixLength, MAX_PREFIX - length));
+            }
+            memcpy(child->prefix, node4->prefix, MAX_PREFIX);
+            child->prefixLength += node4->prefixLength + 1;
+        }
+        *slot = child;
+        freeNode(node4);
+        return;
+    }
+    case NODE16: {
+        Node16* node16 = static_cast<Node16*>(node);
+        unsigned int index = 0;
+        while (node16->keys[index] != byte) {
+            index++;
+        }
+        memmove(node16->keys + index, node16->keys + index + 1, node16->count - index - 1);
+        memmove(node16->children + index, node16->children + index + 1, (node16->count - index - 1) * sizeof(ArtNode*));
+        node16->count--;
+        if (node16->count > 3) {
+            return;
+        }
+
+        Node4* shrunk = newNode<Node4>(node16);
+        memcpy(shrunk->keys, node16->keys, node16->count);
+        memcpy(shrunk->children, node16->children, node16->count * sizeof(ArtNode*));
+        shrunk->count = node16->count;
+        *slot = shrunk;
+        freeNode(node16);
+        return;
+    }
+    case NODE48: {
+        Node48* node48 = static_cast<Node48*>(node);
+        node48->children[node48->childIndex[byte] - 1] = nullptr;
+        node48->childIndex[byte] = 0;
+        node48->count--;
+        if (node48->count > 12) {
+            return;
+        }
+
+        Node16* shrunk = newNode<Node16>(node48);
+        for (unsigned int b = 0; b < 256; b++) {
+            if (node48->childIndex[b] != 0) {
+                shrunk->keys[shrunk->count] = static_cast<uint8_t>(b);
+                shrunk->children[shrunk->count++] = node48->children[node48->childIndex[b] - 1];
+            }
+        }
+        *slot = shrunk;
+        freeNode(node48);
+        return;
+    }
+    case NODE256: {
+        Node256* node256 = static_cast<Node256*>(node);
+        node256->children[byte] = nullptr;
+        node256->count--;
+        if (node256->count > 37) {
+            return;
+        }
+
+        Node48* shrunk = newNode<Node48>(node256);
+        for (unsigned int b = 0; b < 256; b++) {
+            if (node256->children[b] != nullptr) {
+                shrunk->children[shrunk->count] = node256->children[b];
+                shrunk->childIndex[b] = static_cast<uint8_t>(++shrunk->count);
+            }
+        }
+        *slot = shrunk;
+        freeNode(node256);
+        return;
+    }
+    }
+}
+
+/**
+ * Insert a bid below the node in a slot (recursive, the depth is bounded by the id length)
+ *
+ * @param slot The slot holding the subtree, updated if its root is replaced
+ * @param bid The bid to insert
+ * @param depth The number of id bytes consumed above the slot
+ */
+void RadixBidIndex::insertAt(ArtNode** slot, Bid& bid, size_t depth) {
+    ArtNode* node = *slot;
+    const string& key = bid.bidId;
+
+    // Places the bid in an empty slot
+    if (node == nullptr) {
+        *slot = newLeaf(bid);
+        return;
+    }
+
+    // Splits a leaf into a Node4 over the two ids, prefixed with the bytes they share
+    if (isLeaf(node)) {
+        ArtLeaf* leaf = asLeaf(node);
+        if (leaf->bid.bidId == key) {
+            leaf->bid = std::move(bid);
+            return;
+        }
+
+        const string& otherKey = leaf->bid.bidId;
+        size_t common = 0;
+        while (keyByte(otherKey, depth + common) == keyByte(key, depth + common)) {
+            common++;
+        }
+
+        Node4* split = newNode<Node4>(nullptr);
+        split->prefixLength = static_cast<uint32_t>(common);
+        for (size_t i = 0; i < min<size_t>(common, MAX_PREFIX); i++) {
+            split->prefix[i] = keyByte(key, depth + i);
+        }
+        uint8_t newByte = keyByte(key, depth + common);
+        split->keys[0] = keyByte(otherKey, depth + common);
+        split->children[0] = node;
+        split->count = 1;
+        *slot = split;
+        addChild(slot, newByte, newLeaf(bid));
+        return;
+    }
+
+    // Splits the node's prefix where the id leaves it, under a new Node4
+    if (node->prefixLength > 0) {
+        size_t mismatch = prefixMismatch(node, key, depth);
+        if (mismatch < node->prefixLength) {
+            Node4* split = newNode<Node4>(nullptr);
+            split->prefixLength = static_cast<uint32_t>(mismatch);
+            memcpy(split->prefix, node->prefix, min<size_t>(mismatch, MAX_PREFIX));
+
+            // Drops the shared part and the branching byte from the old node's prefix
+            uint8_t oldByte;
+            if (node->prefixLength <= MAX_PREFIX) {
+                oldByte = node->prefix[mismatch];
+                node->prefixLength -= static_cast<uint32_t>(mismatch + 1);
+                memmove(node->prefix, node->prefix + mismatch + 1, node->prefixLength);
+            }
+            else {
+                const string& minKey = minimum(node)->bid.bidId;
+                oldByte = keyByte(minKey, depth + mismatch);
+                node->prefixLength -= static_cast<uint32_t>(mismatch + 1);
+                for (size_t i = 0; i < min<size_t>(node->prefixLength, MAX_PREFIX); i++) {
+                    node->prefix[i] = keyByte(minKey, depth + mismatch + 1 + i);
+                }
+            }
+
+            uint8_t newByte = keyByte(key, depth + mismatch);
+            split->keys[0] = oldByte;
+            split->children[0] = node;
+            split->count = 1;
+            *slot = split;
+            addChild(slot, newByte, newLeaf(bid));
+            return;
+        }
+        depth += node->prefixLength;
+    }
+
+    // Descends into the child for the next byte, or adds the bid as a new child
+    uint8_t byte = keyByte(key, depth);
+    ArtNode** child = findChild(node, byte);
+    if (child != nullptr) {
+        insertAt(child, bid, depth + 1);
+        return;
+    }
+    addChild(slot, byte, newLeaf(bid));
+}
+
+/**
+ * Remove a bid from below the node in a slot (recursive, the depth is bounded by the id length)
+ *
+ * @return True if the id was found
+ */
+bool RadixBidIndex::removeAt(ArtNode** slot, const string& bidId, size_t depth) {
+    ArtNode* node = *slot;
+    if (node == nullptr) {
+        return false;
+    }
+
+    // Only the root can be a lone leaf
+    if (isLeaf(node)) {
+        if (asLeaf(node)->bid.bidId != bidId) {
+            return false;
+        }
+        freeNode(node);
+        *slot = nullptr;
+        return true;
+    }
+
+    if (node->prefixLength > 0) {
+        if (prefixMismatch(node, bidId, depth) != node->prefixLength) {
+            return false;
+        }
+        depth += node->prefixLength;
+    }
+
+    uint8_t byte = keyByte(bidId, depth);
+    ArtNode** child = findChild(node, byte);
+    if (child == nullptr) {
+        return false;
+    }
+
+    // Unlinks a matching leaf from this node, which may shrink or merge as a result
+    if (isLeaf(*child)) {
+        if (asLeaf(*child)->bid.bidId != bidId) {
+            return false;
+        }
+        freeNode(*child);
+        removeChild(slot, byte);
+        return true;
+    }
+    return removeAt(child, bidId, depth + 1);
+}
+
+/**
+ * Call visit(bid) for every bid below a node in id order (recursive, the depth is bounded by the id length)
+ */
+template <typename Visit>
+void RadixBidIndex::forEach(const ArtNode* node, Visit& visit) {
+    if (node == nullptr) {
+        return;
+    }
+    if (isLeaf(node)) {
+        visit(asLeaf(node)->bid);
+        return;
+    }
+
+    switch (node->type) {
+    case NODE4:
+        for (unsigned int i = 0; i < node->count; i++) {
+            forEach(static_cast<const Node4*>(node)->children[i], visit);
+        }
+        break;
+    case NODE16:
+        for (unsigned int i = 0; i < node->count; i++) {
+            forEach(static_cast<const Node16*>(node)->children[i], visit);
+        }
+        break;
+    case NODE48: {
+        const Node48* node48 = static_cast<const Node48*>(node);
+        for (unsigned int b = 0; b < 256; b++) {
+            if (node48->childIndex[b] != 0) {
+                forEach(node48->children[node48->childIndex[b] - 1], visit);
+            }
+        }
+        break;
+    }
+    case NODE256:
+        for (unsigned int b = 0; b < 256; b++) {
+            forEach(static_cast<const Node256*>(node)->children[b], visit);
+        }
+        break;
+    }
+}
+
+/**
+ * Insert a bid, replacing any bid with the same id
+ */
+void RadixBidIndex::Insert(Bid bid) {
+    insertAt(&root, bid, 0);
+}
+
+/**
+ * Add many bids at once
+ */
+void RadixBidIndex::BulkLoad(vector<Bid> bids) {
+    for (Bid& bid : bids) {
+        Insert(std::move(bid));
+    }
+}
+
+/**
+ * Remove a bid
+ */
+void RadixBidIndex::Remove(string bidId) {
+    removeAt(&root, bidId, 0);
+}
+
+/**
+ * Search for a bid
+ */
+Bid RadixBidIndex::Search(string bidId) {
+    const ArtNode* node = root;
+    size_t depth = 0;
+
+    while (node != nullptr) {
+        // Confirms the whole id once a leaf is reached, which also covers skipped prefix bytes
+        if (isLeaf(node)) {
+            ArtLeaf* leaf = asLeaf(node);
+            return leaf->bid.bidId == bidId ? leaf->bid : Bid();
+        }
+
+        // Checks the stored prefix bytes and skips over the whole prefix
+        if (node->prefixLength > 0) {
+            size_t stored = min<size_t>(node->prefixLength, MAX_PREFIX);
+            for (size_t i = 0; i < stored; i++) {
+                if (node->prefix[i] != keyByte(bidId, depth + i)) {
+                    return Bid();
+                }
+            }
+            depth += node->prefixLength;
+        }
+
+        // Stops once the id, including its terminating byte, is used up
+        if (depth > bidId.size()) {
+            return Bid();
+        }
+        ArtNode** child = findChild(const_cast<ArtNode*>(node), keyByte(bidId, depth));
+        node = child != nullptr ? *child : nullptr;
+        depth++;
+    }
+
+    return Bid();
+}
+
+/**
+ * Traverse the bids in id order
+ */
+void RadixBidIndex::InOrder() {
+    auto print = [](const Bid& bid) {
+        cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+            << bid.fund << endl;
+    };
+    forEach(root, print);
+}
+
+/**
+ * Find every bid whose id starts with a prefix, in id order
+ *
+ * @param prefix The leading characters to match, e.g. "98"
+ */
+vector<Bid> RadixBidIndex::PrefixScan(const string& prefix) {
+    vector<Bid> bids;
+    auto collect = [&bids](const Bid& bid) {
+        bids.push_back(bid);
+    };
+
+    // Descends while the prefix still has bytes left to match
+    const ArtNode* node = root;
+    size_t depth = 0;
+    while (node != nullptr && !isLeaf(node) && depth < prefix.size()) {
+        // Compares the node's prefix with as much of the search prefix as it covers
+        if (node->prefixLength > 0) {
+            const string* minKey = nullptr;
+            for (size_t i = 0; i < node->prefixLength && depth + i < prefix.size(); i++) {
+                uint8_t byte;
+                if (i < MAX_PREFIX) {
+                    byte = node->prefix[i];
+                }
+                else {
+                    if (minKey == nullptr) {
+                        minKey = &minimum(node)->bid.bidId;
+                    }
+                    byte = keyByte(*minKey, depth + i);
+                }
+                if (byte != static_cast<uint8_t>(prefix[depth + i])) {
+                    return bids;
+                }
+            }
+            depth += node->prefixLength;
+            if (depth >= prefix.size()) {
+                break;
+            }
+        }
+
+        ArtNode** child = findChild(const_cast<ArtNode*>(node), static_cast<uint8_t>(prefix[depth]));
+        node = child != nullptr ? *child : nullptr;
+        depth++;
+    }
+
+    // A leaf reached early still has to be checked against the rest of the prefix
+    if (node != nullptr && isLeaf(node) && asLeaf(node)->bid.bidId.compare(0, prefix.size(), prefix) != 0) {
+        return bids;
+    }
+
+    // Every bid below the node shares the prefix
+    forEach(node, collect);
+    return bids;
+}
+
+/**
+ * Returns the number of bids in the tree
+ */
+size_t RadixBidIndex::Size() {
+    return size;
+}
+
+/**
+ * Returns the bytes allocated for the tree's nodes and leaves, not counting
+ * the bids' string contents
+ */
+size_t RadixBidIndex::MemoryUsage() {
+    return bytesUsed;
+}
+
+//============================================================================
+// Concurrent skip list class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a lock-free skip list of bids ordered by bid id.
+ *
+ * Any number of threads may Insert, Remove and Search at once. Each node
+ * is linked into a random number of levels, one more level with the
+ * configured probability, so a search skips ahead along the sparse upper
+ * levels before walking the full list at level 0. Links are changed only
+ * with compare-and-swap. A removal first marks the low bit of each of the
+ * node's outgoing links, which stops anyone from linking after it, and
+ * then any thread that passes the marked node unlinks it. Bids are never
+ * changed once linked, and removed nodes are kept until the list is
+ * destroyed, so a thread can never reach freed memory. Bid ids are
+ * unique: inserting an existing id keeps the bid already in the list.
+ */
+class SkipListBidIndex {
+
+private:
+    static const int MAX_LEVEL = 24;
+
+    // Define a structure for the list nodes, next[i] being the link at level i
+    struct SkipNode {
+        const Bid bid;
+        const int topLevel;
+        unique_ptr<atomic<uintptr_t>[]> next;
+        // links the node into the list of removed nodes
+        SkipNode* retiredNext = nullptr;
+
+        SkipNode(const Bid& aBid, int levels) : bid(aBid), topLevel(levels - 1),
+                next(new atomic<uintptr_t>[levels]) {
+            for (int i = 0; i < levels; i++) {
+                next[i].store(0, memory_order_relaxed);
+            }
+        }
+    };
+
+    SkipNode head;
+    double levelProbability;
+    atomic<size_t> count{0};
+    atomic<SkipNode*> retired{nullptr};
+
+    static SkipNode* pointerOf(uintptr_t link);
+    static bool isMarked(uintptr_t link);
+    int randomLevels();
+    bool find(const string& bidId, SkipNode** preds, SkipNode** succs);
+
+public:
+    SkipListBidIndex(double levelProbability = 0.25);
+    virtual ~SkipListBidIndex();
+    bool Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
+    bool Remove(string bidId);
+    Bid Search(string bidId);
+    template <typename Visit> void ForEach(Visit visit);
+    void InOrder();
+    size_t Size();
+};
+
+// Definition for the class constant, needed when it is bound to a reference
+const int SkipListBidIndex::MAX_LEVEL;
+
+/**
+ * Constructor
+ *
+ * @param levelProbability The chance that a node reaches each next level, between 0.05 and 0.75
+ */
+SkipListBidIndex::SkipListBidIndex(double levelProbability) : head(Bid(), MAX_LEVEL) {
+    this->levelProbability = min(0.75, max(levelProbability, 0.05));
+}
+
+/**
+ * Destructor, which must run once no other thread is using the list
+ */
+SkipListBidIndex::~SkipListBidIndex() {
+    // Frees the nodes still linked at level 0, skipping removed ones, which are freed below
+    SkipNode* node = pointerOf(head.next[0].load());
+    while (node != nullptr) {
+        uintptr_t link = node->next[0].load();
+        if (!isMarked(link)) {
+            delete node;
+        }
+        node = pointerOf(link);
+    }
+
+    // Frees every removed node
+    node = retired.load();
+    while (node != nullptr) {
+        SkipNode* nextRetired = node->retiredNext;
+        delete node;
+        node = nextRetired;
+    }
+}
+
+/**
+ * Returns the node a link points to, ignoring its mark
+ */
+SkipListBidIndex::SkipNode* SkipListBidIndex::pointerOf(uintptr_t link) {
+    return reinterpret_cast<SkipNode*>(link & ~static_cast<uintptr_t>(1));
+}
+
+/**
+ * Returns true if a link belongs to a node that is being removed
+ */
+bool SkipListBidIndex::isMarked(uintptr_t link) {
+    return (link & 1) != 0;
+}
+
+/**
+ * Pick a new node's number of levels, each further level with levelProbability
+ */
+int SkipListBidIndex::randomLevels() {
+    // Gives each thread its own generator so inserts do not contend on one
+    static thread_local mt19937 random(static_cast<unsigned int>(hash<thread::id>()(this_thread::get_id())));
+    uniform_real_distribution<double> coin(0.0, 1.0);
+
+    int levels = 1;
+    while (levels < MAX_LEVEL && coin(random) < levelProbability) {
+        levels++;
+    }
+    return levels;
+}
+
+/**
+ * Find the nodes before and after an id at every level, unlinking any
+ * marked nodes passed on the way
+ *
+ * @param preds Set to the last node before the id at each level
+ * @param succs Set to the first node not before the id at each level
+ * @return True if an unmarked node with the id was found at level 0
+ */
+bool SkipListBidIndex::find(const string& bidId, SkipNode** preds, SkipNode** succs) {
+retry:
+    SkipNode* pred = &head;
+    for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+        SkipNode* curr = pointerOf(pred->next[level].load());
+        while (curr != nullptr) {
+            uintptr_t succ = curr->next[level].load();
+
+            // Unlinks a node being removed, starting over if pred changed under us
+            if (isMarked(succ)) {
+                uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+                if (!pred->next[level].compare_exchange_strong(expected, succ & ~static_cast<uintptr_t>(1))) {
+                    goto retry;
+                }
+                curr = pointerOf(succ);
+                continue;
+            }
+
+            if (curr->bid.bidId < bidId) {
+                pred = curr;
+                curr = pointerOf(succ);
+            }
+            else {
+                break;
+            }
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+
+    return succs[0] != nullptr && succs[0]->bid.bidId == bidId;
+}
+
+/**
+ * Insert a bid
+ *
+ * @return False if the id was already in the list, which is left unchanged
+ */
+bool SkipListBidIndex::Insert(Bid bid) {
+    SkipNode* preds[MAX_LEVEL];
+    SkipNode* succs[MAX_LEVEL];
+    SkipNode* node = nullptr;
+
+    while (true) {
+        if (find(bid.bidId, preds, succs)) {
+            delete node;
+            return false;
+        }
+
+        // Builds the node once, pointing each of its levels at the successor found
+        if (node == nullptr) {
+            node = new SkipNode(bid, randomLevels());
+        }
+        for (int level = 0; level <= node->topLevel; level++) {
+            node->next[level].store(reinterpret_cast<uintptr_t>(succs[level]), memory_order_relaxed);
+        }
+
+        // Linking level 0 puts the bid in the list, the upper levels only speed up searches
+        uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+        if (preds[0]->next[0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+            break;
+        }
+    }
+    count++;
+
+    for (int level = 1; level <= node->topLevel; level++) {
+        while (true) {
+            uintptr_t expected = reinterpret_cast<uintptr_t>(succs[level]);
+            if (preds[level]->next[level].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node))) {
+                break;
+            }
+
+            // Finds the new neighbours, giving up if the node is already being removed
+            find(node->bid.bidId, preds, succs);
+            uintptr_t link = node->next[level].load();
+            if (isMarked(link)) {
+                return true;
+            }
+            if (pointerOf(link) != succs[level]
+                && !node->next[level].compare_exchange_strong(link, reinterpret_cast<uintptr_t>(succs[level]))) {
+                return true;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Add many bids at once, split across one thread per hardware thread
+ * Each thread inserts one contiguous run of the id-sorted bids, so the
+ * threads mostly work in different parts of the list.
+ *
+ * @param bids The bids to add
+ */
+void SkipListBidIndex::BulkLoad(vector<Bid> bids) {
+    auto byId = [](const Bid& a, const Bid& b) { return a.bidId < b.bidId; };
+    if (!is_sorted(bids.begin(), bids.end(), byId)) {
+        stable_sort(bids.begin(), bids.end(), byId);
+    }
+
+    size_t threadCount = max(1u, thread::hardware_concurrency());
+    vector<thread> loaders;
+    for (size_t t = 0; t < threadCount; t++) {
+        size_t first = bids.size() * t / threadCount;
+        size_t last = bids.size() * (t + 1) / threadCount;
+        loaders.emplace_back([this, &bids, first, last]() {
+            for (size_t i = first; i < last; i++) {
+                Insert(bids[i]);
+            }
+        });
+    }
+    for (thread& loader : loaders) {
+        loader.join();
+    }
+}
+
+/**
+ * Remove a bid
+ *
+ * @return True if this call removed the bid
+ */
+bool SkipListBidIndex::Remove(string bidId) {
+    SkipNode* preds[MAX_LEVEL];
+    SkipNode* succs[MAX_LEVEL];
+    if (!find(bidId, preds, succs)) {
+        return false;
+    }
+    SkipNode* node = succs[0];
+
+    // Marks the upper levels top-down so no new link can be made after the node
+    for (int level = node->topLevel; level >= 1; level--) {
+        uintptr_t link = node->next[level].load();
+        while (!isMarked(link)) {
+            node->next[level].compare_exchange_weak(link, link | 1);
+        }
+    }
+
+    // Marking level 0 removes the bid; only one thread can succeed
+    uintptr_t link = node->next[0].load();
+    while (true) {
+        if (isMarked(link)) {
+            return false;
+        }
+        if (node->next[0].compare_exchange_weak(link, link | 1)) {
+            break;
+        }
+    }
+
+    // Unlinks the node at every level, then keeps it for freeing with the list
+    find(bidId, preds, succs);
+    node->retiredNext = retired.load();
+    while (!retired.compare_exchange_weak(node->retiredNext, node)) {
+    }
+    count--;
+    return true;
+}
+
+/**
+ * Search for a bid, without changing any link
+ */
+Bid SkipListBidIndex::Search(string bidId) {
+    SkipNode* pred = &head;
+    SkipNode* curr = nullptr;
+    for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+        curr = pointerOf(pred->next[level].load());
+        while (curr != nullptr) {
+            uintptr_t succ = curr->next[level].load();
+            // Steps over nodes being removed
+            if (isMarked(succ)) {
+                curr = pointerOf(succ);
+            }
+            else if (curr->bid.bidId < bidId) {
+                pred = curr;
+                curr = pointerOf(succ);
+            }
+            else {
+                break;
+            }
+        }
+    }
+
+    if (curr != nullptr && curr->bid.bidId == bidId && !isMarked(curr->next[0].load())) {
+        return curr->bid;
+    }
+    return Bid();
+}
+
+/**
+ * Call visit(bid) for every bid in id order, walking level 0
+ * Bids inserted or removed during the walk may or may not be visited.
+ */
+template <typename Visit>
+void SkipListBidIndex::ForEach(Visit visit) {
+    SkipNode* node = pointerOf(head.next[0].load());
+    while (node != nullptr) {
+        uintptr_t link = node->next[0].load();
+        if (!isMarked(link)) {
+            visit(node->bid);
+        }
+        node = pointerOf(link);
+    }
+}
+
+/**
+ * Traverse the bids in order
+ */
+void SkipListBidIndex::InOrder() {
+    ForEach([](const Bid& bid) {
+        cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+            << bid.fund << endl;
+    });
+}
+
+/**
+ * Returns the number of bids in the list
+ */
+size_t SkipListBidIndex::Size() {
+    return count.load();
+}
+
+//============================================================================
+// B+ Tree class definition
+//============================================================================
+
+/**
+ * Define a class containing data members and methods to
+ * implement a B+ tree of bids keyed by bid id.
+ *
+ * Inner nodes hold up to INNER_KEYS separator keys and only route searches;
+ * every bid lives in a leaf and the leaves are linked in key order, so an
+ * in-order scan walks the leaf list without touching the inner nodes. Each
+ * node keeps the first eight bytes of its keys packed into an array of
+ * integers in front of the full strings, so most comparisons on the way
+ * down read a few consecutive cache lines and never follow a string's
+ * pointer. Bid ids are unique: inserting an existing id replaces its bid.
+ */
+class BPlusTree {
+
+private:
+    static const unsigned int INNER_KEYS = 31;
+    static const unsigned int LEAF_KEYS = 16;
+
+    // Define the fields shared by inner nodes and leaves
+    struct alignas(64) BNode {
+        bool isLeaf;
+        unsigned int count;
+
+        BNode(bool leaf) {
+            isLeaf = leaf;
+            count = 0;
+        }
+    };
+
+    // Define a structure for inner nodes, children[i] holds keys below keys[i]
+    struct InnerNode : BNode {
+        uint64_t prefixes[INNER_KEYS];
+        BNode* children[INNER_KEYS + 1];
+        string keys[INNER_KEYS];
+
+        InnerNode() : BNode(false) {
+        }
+    };
+
+    // Define a structure for leaves, which hold the bids themselves
+    struct LeafNode : BNode {
+        uint64_t prefixes[LEAF_KEYS];
+        LeafNode* prev = nullptr;
+        LeafNode* next = nullptr;
+        Bid bids[LEAF_KEYS];
+
+        LeafNode() : BNode(true) {
+        }
+    };
+
+    BNode* root = nullptr;
+    LeafNode* firstLeaf = nullptr;
+    size_t size = 0;
+    int levels = 0;
+
+    static uint64_t prefixOf(const string& key);
+    static bool keyLess(uint64_t prefixA, const string& a, uint64_t prefixB, const string& b);
+    static unsigned int childIndex(InnerNode* node, uint64_t prefix, const string& key);
+    static unsigned int leafIndex(LeafNode* leaf, uint64_t prefix, const string& key);
+    bool insertInto(BNode* node, Bid& bid, uint64_t prefix, string& splitKey, BNode*& splitNode);
+    bool removeFrom(BNode* node, uint64_t prefix, const string& bidId);
+    void fixUnderflow(InnerNode* parent, unsigned int index);
+    static void insertIntoInner(InnerNode* node, unsigned int index, string& key, BNode* child);
+    static void eraseFromInner(InnerNode* node, unsigned int index);
+    void destroy(BNode* node);
+
+public:
+    BPlusTree();
+    virtual ~BPlusTree();
+    void InOrder();
+    void Insert(Bid bid);
+    void BulkLoad(vector<Bid> bids);
+    void Remove(string bidId);
+    Bid Search(string bidId);
+    size_t Size();
+    int Height();
+};
+
+// Definitions for the class constants, needed when they are bound to references
+const unsigned int BPlusTree::INNER_KEYS;
+const unsigned int BPlusTree::LEAF_KEYS;
+
+/**
+ * Default constructor
+ */
+BPlusTree::BPlusTree() {
+}
+
+/**
+ * Destructor
+ */
+BPlusTree::~BPlusTree() {
+    destroy(root);
+}
+
+/**
+ * Free a subtree (recursive, the depth is the tree's small height)
+ */
+void BPlusTree::destroy(BNode* node) {
+    if (node == nullptr) {
+        return;
+    }
+
+    if (node->isLeaf) {
+        delete static_cast<LeafNode*>(node);
+    }
+    else {
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        for (unsigned int i = 0; i <= inner->count; i++) {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+}
+
+/**
+ * Pack a key's first eight bytes into an integer that orders like the key
+ *
+ * @param key The bid id
  */
-BinarySearchTree::BinarySearchTree() {
-    // Points the start of the tree, the root, to a null value
-    root = nullptr;
+uint64_t BPlusTree::prefixOf(const string& key) {
+    uint64_t prefix = 0;
+    for (size_t i = 0; i < 8; i++) {
+        prefix <<= 8;
+        if (i < key.size()) {
+            prefix |= static_cast<unsigned char>(key[i]);
+        }
+    }
+    return prefix;
 }
 
 /**
- * Destructor
+ * Compare two keys, falling back to the full strings only when their prefixes tie
  */
-BinarySearchTree::~BinarySearchTree() {
-
-    Node* currNode = root;
-
-    while (currNode != nullptr) {
-        currNode = removeNode(currNode, currNode->bid.bidId);
+bool BPlusTree::keyLess(uint64_t prefixA, const string& a, uint64_t prefixB, const string& b) {
+    if (prefixA != prefixB) {
+        return prefixA < prefixB;
     }
+    return a < b;
 }
 
 /**
- * Traverse the tree in order
+ * Find the child of an inner node whose range holds a key
+ *
+ * @return The index of the first separator greater than the key
  */
-void BinarySearchTree::InOrder() {
-    // Call the inOrder recursive function and pass in the root to begin traversal
-    inOrder(root);
+unsigned int BPlusTree::childIndex(InnerNode* node, uint64_t prefix, const string& key) {
+    // Binary searches the separators, mostly reading only the packed prefixes
+    unsigned int low = 0;
+    unsigned int high = node->count;
+    while (low < high) {
+        unsigned int middle = (low + high) / 2;
+        if (keyLess(prefix, key, node->prefixes[middle], node->keys[middle])) {
+            high = middle;
+        }
+        else {
+            low = middle + 1;
+        }
+    }
+    return low;
 }
 
 /**
- * Traverse the tree in post-order
+ * Find a key's position within a leaf
+ *
+ * @return The index of the first bid not less than the key
  */
-void BinarySearchTree::PostOrder() {
-    // Call the postOrder recursive function and pass in the root to begin traversal
-    postOrder(root);
+unsigned int BPlusTree::leafIndex(LeafNode* leaf, uint64_t prefix, const string& key) {
+    unsigned int low = 0;
+    unsigned int high = leaf->count;
+    while (low < high) {
+        unsigned int middle = (low + high) / 2;
+        if (keyLess(leaf->prefixes[middle], leaf->bids[middle].bidId, prefix, key)) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low;
 }
 
 /**
- * Traverse the tree in pre-order
+ * Traverse the bids in order by walking the linked leaves
  */
-void BinarySearchTree::PreOrder() {
-    // Call the preOrder recursive function and pass in the root to begin traversal
-    preOrder(root);
+void BPlusTree::InOrder() {
+    for (LeafNode* leaf = firstLeaf; leaf != nullptr; leaf = leaf->next) {
+        for (unsigned int i = 0; i < leaf->count; i++) {
+            Bid& bid = leaf->bids[i];
+            cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
+                << bid.fund << endl;
+        }
+    }
 }
 
+/**
+ * Search for a bid
+ */
+Bid BPlusTree::Search(string bidId) {
+    if (root == nullptr) {
+        return Bid();
+    }
+
+    // Descends through the inner nodes to the leaf covering the id
+    uint64_t prefix = prefixOf(bidId);
+    BNode* node = root;
+    while (!node->isLeaf) {
+        InnerNode* inner = static_cast<InnerNode*>(node);
+        node = inner->children[childIndex(inner, prefix, bidId)];
+    }
+
+    // Checks if the leaf holds the id
+    LeafNode* leaf = static_cast<LeafNode*>(node);
+    unsigned int i = leafIndex(leaf, prefix, bidId);
+    if (i < leaf->count && leaf->prefixes[i] == prefix && leaf->bids[i].bidId == bidId) {
+        return leaf->bids[i];
+    }
 
+    // Returns an empty bid, indicating the bid id is not in the tree
+    return Bid();
+}
 
 /**
- * Insert a bid
+ * Insert a bid, replacing any bid with the same id
  */
-void BinarySearchTree::Insert(Bid bid) {
-    // Check if the tree's root is empty
+void BPlusTree::Insert(Bid bid) {
+    // Starts the tree with a single leaf
     if (root == nullptr) {
-        // Initialize a new node and assign it to the tree's root
-        root = new Node(bid);
+        firstLeaf = new LeafNode();
+        root = firstLeaf;
+        levels = 1;
     }
-    else {
-        // Call the addNode recursive function and pass in the root and new bid to-be added
-        addNode(root, bid);
+
+    // Grows a new root above the old one when the old root splits
+    string splitKey;
+    BNode* splitNode = nullptr;
+    if (insertInto(root, bid, prefixOf(bid.bidId), splitKey, splitNode)) {
+        InnerNode* newRoot = new InnerNode();
+        newRoot->children[0] = root;
+        newRoot->children[1] = splitNode;
+        newRoot->keys[0] = std::move(splitKey);
+        newRoot->prefixes[0] = prefixOf(newRoot->keys[0]);
+        newRoot->count = 1;
+        root = newRoot;
+        levels++;
     }
 }
 
 /**
- * Remove a bid
+ * Add many bids at once
+ * Sorted bids are inserted in order, so each insert lands in the leaf the
+ * previous one touched and stays in cache.
+ *
+ * @param bids The bids to add
  */
-void BinarySearchTree::Remove(string bidId) {
-    // Call the removeNode recursive function and pass in the root and id of node to-be removed
-    removeNode(root, bidId);
+void BPlusTree::BulkLoad(vector<Bid> bids) {
+    auto byId = [](const Bid& a, const Bid& b) { return a.bidId < b.bidId; };
+    if (!is_sorted(bids.begin(), bids.end(), byId)) {
+        stable_sort(bids.begin(), bids.end(), byId);
+    }
+
+    for (Bid& bid : bids) {
+        Insert(std::move(bid));
+    }
 }
 
 /**
- * Search for a bid
+ * Add a separator and the child to its right to an inner node with room for them
  */
-Bid BinarySearchTree::Search(string bidId) {
-    // Initialize a new pointer pointing to the tree's root
-    Node* currNode = root;
-
-    // Traverse the tree until the currNode is null
-    while (currNode != nullptr) {
-        // Check if the currNode's bid matches the passed in bid id
-        if (currNode->bid.bidId == bidId) { // Indicates the desired bid was found
-            // Exit the method and return the currNode's bid
-            return currNode->bid;
-        }
-        // Check if the currNode's bid id is greater than the passed in bid id
-        else if (currNode->bid.bidId > bidId) { // Indicates the left child should be searched
-            // Navigate to the left child
-            currNode = currNode->left;
-        }
-        else { // Indicates the right child should be searched=
-            // Navigate to the right child
-            currNode = currNode->right;
-        }
+void BPlusTree::insertIntoInner(InnerNode* node, unsigned int index, string& key, BNode* child) {
+    for (unsigned int i = node->count; i > index; i--) {
+        node->keys[i] = std::move(node->keys[i - 1]);
+        node->prefixes[i] = node->prefixes[i - 1];
+        node->children[i + 1] = node->children[i];
     }
-    
-    // Initialize an empty bid
-    Bid bid;
-    // Exit the function and return the empty bid, indicating the bid id has no associated node in the tree
-    return bid;
+    node->keys[index] = std::move(key);
+    node->prefixes[index] = prefixOf(node->keys[index]);
+    node->children[index + 1] = child;
+    node->count++;
 }
 
 /**
- * Add a bid to some node (recursive)
+ * Add a bid below some node (recursive)
  *
  * @param node Current node in tree
  * @param bid Bid to be added
+ * @param prefix The bid id's packed prefix
+ * @param splitKey Set to the smallest key of the new right sibling if the node split
+ * @param splitNode Set to the new right sibling if the node split
+ * @return True if the node split
  */
-void BinarySearchTree::addNode(Node* node, Bid bid) {
-    // Checks if the current node's bid id is greater than the passed in bid's id
-    if (node->bid.bidId > bid.bidId) { // Indicates the new bid's id is less than the current node's bid id and needs to be assigne to the left
-        // Checks if the current node's left child is unoccupied
-        if (node->left == nullptr) {
-            // Initializes a new node using the passed in bid and assigns it to the left child node
-            node->left = new Node(bid);
+bool BPlusTree::insertInto(BNode* node, Bid& bid, uint64_t prefix, string& splitKey, BNode*& splitNode) {
+    if (node->isLeaf) {
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        unsigned int index = leafIndex(leaf, prefix, bid.bidId);
+
+        // Replaces the bid if the id is already present
+        if (index < leaf->count && leaf->bids[index].bidId == bid.bidId) {
+            leaf->bids[index] = std::move(bid);
+            return false;
         }
-        else { // Indicates that the left child is occupied
-            // Recursively call the addNode method to traverse to the left child
-            addNode(node->left, bid);
+
+        // Splits a full leaf in half first, linking the new leaf in after it
+        LeafNode* target = leaf;
+        bool split = false;
+        if (leaf->count == LEAF_KEYS) {
+            LeafNode* sibling = new LeafNode();
+            unsigned int half = LEAF_KEYS / 2;
+            for (unsigned int i = half; i < LEAF_KEYS; i++) {
+                sibling->bids[i - half] = std::move(leaf->bids[i]);
+                sibling->prefixes[i - half] = leaf->prefixes[i];
+            }
+            sibling->count = LEAF_KEYS - half;
+            leaf->count = half;
+
+            sibling->next = leaf->next;
+            sibling->prev = leaf;
+            if (leaf->next != nullptr) {
+                leaf->next->prev = sibling;
+            }
+            leaf->next = sibling;
+
+            if (index > half) {
+                target = sibling;
+                index -= half;
+            }
+            splitNode = sibling;
+            split = true;
         }
-    }
-    else { // Indicates new bid's id is greater than or equal to the current node's bid id and needs be assigned to the right
-        // Checks if the current node's right child is unoccupied
-        if (node->right == nullptr) {
-            // Initializes a new node using the passed in bid and assigns it to the right child node
-            node->right = new Node(bid);
+
+        // Shifts the larger bids up and places the new one
+        for (unsigned int i = target->count; i > index; i--) {
+            target->bids[i] = std::move(target->bids[i - 1]);
+            target->prefixes[i] = target->prefixes[i - 1];
         }
-        else {
-            // Recursively call the addNode method to traverse to the right child
-            addNode(node->right, bid);
+        target->bids[index] = std::move(bid);
+        target->prefixes[index] = prefix;
+        target->count++;
+        size++;
+
+        if (split) {
+            splitKey = static_cast<LeafNode*>(splitNode)->bids[0].bidId;
         }
+        return split;
     }
-}
 
-void BinarySearchTree::inOrder(Node* node) {
-    // Exit the method once a null value is reached
-    if (node == nullptr) {
-        return;
+    // Descends into the child covering the id
+    InnerNode* inner = static_cast<InnerNode*>(node);
+    unsigned int index = childIndex(inner, prefix, bid.bidId);
+    string childKey;
+    BNode* childSplit = nullptr;
+    if (!insertInto(inner->children[index], bid, prefix, childKey, childSplit)) {
+        return false;
     }
 
-    // Recursively call to visit the node's left child
-    inOrder(node->left);
-    // Call the display function to output the node's bid info
-    printNode(node);
-    // Recursively call to visit the node's right child
-    inOrder(node->right);
-}
+    // Adds the child's new sibling directly if there is room
+    if (inner->count < INNER_KEYS) {
+        insertIntoInner(inner, index, childKey, childSplit);
+        return false;
+    }
 
-void BinarySearchTree::postOrder(Node* node) {
-    // Exit the method once a null value is reached
-    if (node == nullptr) {
-        return;
+    // Splits a full inner node, moving its middle separator up to the parent
+    InnerNode* sibling = new InnerNode();
+    unsigned int middle = INNER_KEYS / 2;
+    for (unsigned int i = middle + 1; i < INNER_KEYS; i++) {
+        sibling->keys[i - middle - 1] = std::move(inner->keys[i]);
+        sibling->prefixes[i - middle - 1] = inner->prefixes[i];
+        sibling->children[i - middle - 1] = inner->children[i];
+    }
+    sibling->children[INNER_KEYS - middle - 1] = inner->children[INNER_KEYS];
+    sibling->count = INNER_KEYS - middle - 1;
+    splitKey = std::move(inner->keys[middle]);
+    inner->count = middle;
+
+    // Places the child's new sibling in whichever half now holds the child
+    if (index <= middle) {
+        insertIntoInner(inner, index, childKey, childSplit);
+    }
+    else {
+        insertIntoInner(sibling, index - middle - 1, childKey, childSplit);
     }
 
-    // Recursively call to visit the node's left child
-    postOrder(node->left);
-    // Recursively call to visit the node's right child
-    postOrder(node->right);
-    // Call the display function to output the node's bid info
-    printNode(node);
+    splitNode = sibling;
+    return true;
 }
 
-void BinarySearchTree::preOrder(Node* node) {
-    // Exit the method once a null value is reached
-    if (node == nullptr) {
+/**
+ * Remove a bid
+ */
+void BPlusTree::Remove(string bidId) {
+    if (root == nullptr || !removeFrom(root, prefixOf(bidId), bidId)) {
         return;
     }
 
-    // Call the display function to output the node's bid info
-    printNode(node);
-    // Recursively call to visit the node's left child
-    preOrder(node->left);
-    // Recursively call to visit the node's right child
-    preOrder(node->right);
+    // Drops a root that has been left with a single child
+    if (!root->isLeaf && root->count == 0) {
+        InnerNode* oldRoot = static_cast<InnerNode*>(root);
+        root = oldRoot->children[0];
+        delete oldRoot;
+        levels--;
+    }
+    // Frees the last leaf once the tree is empty
+    else if (root->isLeaf && root->count == 0) {
+        delete static_cast<LeafNode*>(root);
+        root = nullptr;
+        firstLeaf = nullptr;
+        levels = 0;
+    }
 }
 
 /**
- * Remove a bid from some node (recursive)
+ * Remove a separator and the child to its right from an inner node
  */
-Node* BinarySearchTree::removeNode(Node* node, string bidId) {
-    // Check if the passed in pointer is null
-    if (node == nullptr) {
-        // Exit the function as the bid id was not found
-        return node;
+void BPlusTree::eraseFromInner(InnerNode* node, unsigned int index) {
+    for (unsigned int i = index; i + 1 < node->count; i++) {
+        node->keys[i] = std::move(node->keys[i + 1]);
+        node->prefixes[i] = node->prefixes[i + 1];
+        node->children[i + 1] = node->children[i + 2];
     }
-    // Check if the current node's bid id is less than the passed in bidId
-    else if (node->bid.bidId > bidId) { // Indicates that the left child needs to be searched
-        // Recursively call the removeNode method with the current node's left child
-            // The returned node will become the current node's new left child upon finding the to-be removed node
-        node->left = removeNode(node->left, bidId);
-    }
-    // Check if the currNode's bid id is greater than the passed in bidId
-    else if (node->bid.bidId < bidId) { // Indicates that the right child needs to be searched
-        // Recursively call the removeNode method with the current node's right child
-            // The returned node will become the current node's new right child upon finding the to-be removed node
-        node->right = removeNode(node->right, bidId);
-    }
-    else { // Indicates that the current node is to be removed
-        // Check if the node has any child nodes 
-        if (node->left == nullptr && node->right == nullptr) { // Indicates that it is a leaf node and can be removed
-            // Delete the node
-            delete node;
-            // Point node to null
-            node = nullptr;
-        }
-        // Check if the left child is occupied
-        else if (node->left != nullptr && node->right == nullptr) { // Indicates the left child can be assigned to the current node
-            // Initializes a temporary var to hold to-be removed node
-            Node* removedNode = node;
-            // Assigns the current node's left child to the current node
-            node = node->left;
-            // Frees the to-be removed node from memory
-            delete removedNode;
-            // Points the temporary var to null
-            removedNode = nullptr;
-        }
-        // Check if the right child is occupied
-        else if (node->left == nullptr && node->right != nullptr) { // Indicates the right child can be assigned to the current node
-            // Initializes a temporary var to hold to-be removed node
-            Node* removedNode = node;
-            // Assigns the current node's left child to the current node
-            node = node->right;
-            // Frees the to-be removed node from memory
-            delete removedNode;
-            // Points the temporary var to null
-            removedNode = nullptr;
-        }
-        else { // Indicates both children are occupied, and the successive node must be found
-            // Initializes a pointer pointing to the current node's right child
-            Node* succNode = node->right;
-            // Traverses the tree until the current node's successive node is found
-            while (succNode->left != nullptr) {
-                succNode = succNode->left;
-            }
-            // Initialize a temp var to hold the succNode's bid data
-            Bid succNodeBidData = succNode->bid;
-            // Assign the current node's bid data to the successor's bid data
-            node->bid = succNodeBidData;
-            // Recursively call the removeNode method to remove the successive node from the tree
-                //Passing in the current node's right node and the succNode's bid id
-            node->right = removeNode(node->right, succNodeBidData.bidId);
-        }
-    }
-    // Exit the method and return the current node
-    return node;
+    node->count--;
 }
 
-void BinarySearchTree::printNode(Node* node) {
-    // Initialize a temp var to hold the bid info
-    Bid bid = node->bid;
-    // Display the bid info
-    cout << bid.bidId << ": " << bid.title << " | " << bid.amount << " | "
-        << bid.fund << endl;
-    // Exit method
-    return;
+/**
+ * Remove a bid from below some node (recursive)
+ *
+ * @return True if a bid was removed
+ */
+bool BPlusTree::removeFrom(BNode* node, uint64_t prefix, const string& bidId) {
+    if (node->isLeaf) {
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        unsigned int index = leafIndex(leaf, prefix, bidId);
+        if (index >= leaf->count || leaf->bids[index].bidId != bidId) {
+            return false;
+        }
+
+        // Shifts the larger bids down over the removed one
+        for (unsigned int i = index; i + 1 < leaf->count; i++) {
+            leaf->bids[i] = std::move(leaf->bids[i + 1]);
+            leaf->prefixes[i] = leaf->prefixes[i + 1];
+        }
+        leaf->count--;
+        leaf->bids[leaf->count] = Bid();
+        size--;
+        return true;
+    }
+
+    InnerNode* inner = static_cast<InnerNode*>(node);
+    unsigned int index = childIndex(inner, prefix, bidId);
+    if (!removeFrom(inner->children[index], prefix, bidId)) {
+        return false;
+    }
+
+    // Refills the child if it dropped below half full
+    BNode* child = inner->children[index];
+    unsigned int minimum = child->isLeaf ? LEAF_KEYS / 2 : INNER_KEYS / 2;
+    if (child->count < minimum) {
+        fixUnderflow(inner, index);
+    }
+    return true;
+}
+
+/**
+ * Refill an underfull child by borrowing from a sibling or merging with one
+ *
+ * @param parent The inner node holding the child
+ * @param index The child's index within the parent
+ */
+void BPlusTree::fixUnderflow(InnerNode* parent, unsigned int index) {
+    BNode* child = parent->children[index];
+    BNode* left = index > 0 ? parent->children[index - 1] : nullptr;
+    BNode* right = index < parent->count ? parent->children[index + 1] : nullptr;
+    unsigned int minimum = child->isLeaf ? LEAF_KEYS / 2 : INNER_KEYS / 2;
+
+    if (child->isLeaf) {
+        LeafNode* leaf = static_cast<LeafNode*>(child);
+
+        // Borrows the left sibling's largest bid
+        if (left != nullptr && left->count > minimum) {
+            LeafNode* donor = static_cast<LeafNode*>(left);
+            for (unsigned int i = leaf->count; i > 0; i--) {
+                leaf->bids[i] = std::move(leaf->bids[i - 1]);
+                leaf->prefixes[i] = leaf->prefixes[i - 1];
+            }
+            donor->count--;
+            leaf->bids[0] = std::move(donor->bids[donor->count]);
+            leaf->prefixes[0] = donor->prefixes[donor->count];
+            donor->bids[donor->count] = Bid();
+            leaf->count++;
+
+            parent->keys[index - 1] = leaf->bids[0].bidId;
+            parent->prefixes[index - 1] = leaf->prefixes[0];
+            return;
+        }
+
+        // Borrows the right sibling's smallest bid
+        if (right != nullptr && right->count > minimum) {
+            LeafNode* donor = static_cast<LeafNode*>(right);
+            leaf->bids[leaf->count] = std::move(donor->bids[0]);
+            leaf->prefixes[leaf->count] = donor->prefixes[0];
+            leaf->count++;
+            for (unsigned int i = 0; i + 1 < donor->count; i++) {
+                donor->bids[i] = std::move(donor->bids[i + 1]);
+                donor->prefixes[i] = donor->prefixes[i + 1];
+            }
+            donor->count--;
+            donor->bids[donor->count] = Bid();
+
+            parent->keys[index] = donor->bids[0].bidId;
+            parent->prefixes[index] = donor->prefixes[0];
+            return;
+        }
+
+        // Merges the right one of the pair into the left one and unlinks it
+        unsigned int leftIndex = left != nullptr ? index - 1 : index;
+        LeafNode* into = static_cast<LeafNode*>(parent->children[leftIndex]);
+        LeafNode* from = static_cast<LeafNode*>(parent->children[leftIndex + 1]);
+        for (unsigned int i = 0; i < from->count; i++) {
+            into->bids[into->count + i] = std::move(from->bids[i]);
+            into->prefixes[into->count + i] = from->prefixes[i];
+        }
+        into->count += from->count;
+
+        into->next = from->next;
+        if (from->next != nullptr) {
+            from->next->prev = into;
+        }
+        delete from;
+        eraseFromInner(parent, leftIndex);
+        return;
+    }
+
+    InnerNode* node = static_cast<InnerNode*>(child);
+
+    // Rotates the left sibling's last child through the parent's separator
+    if (left != nullptr && left->count > minimum) {
+        InnerNode* donor = static_cast<InnerNode*>(left);
+        node->children[node->count + 1] = node->children[node->count];
+        for (unsigned int i = node->count; i > 0; i--) {
+            node->keys[i] = std::move(node->keys[i - 1]);
+            node->prefixes[i] = node->prefixes[i - 1];
+            node->children[i] = node->children[i - 1];
+        }
+        node->keys[0] = std::move(parent->keys[index - 1]);
+        node->prefixes[0] = parent->prefixes[index - 1];
+        node->children[0] = donor->children[donor->count];
+        node->count++;
+
+        donor->count--;
+        parent->keys[index - 1] = std::move(donor->keys[donor->count]);
+        parent->prefixes[index - 1] = donor->prefixes[donor->count];
+        return;
+    }
+
+    // Rotates the right sibling's first child through the parent's separator
+    if (right != nullptr && right->count > minimum) {
+        InnerNode* donor = static_cast<InnerNode*>(right);
+        node->keys[node->count] = std::move(parent->keys[index]);
+        node->prefixes[node->count] = parent->prefixes[index];
+        node->children[node->count + 1] = donor->children[0];
+        node->count++;
+
+        parent->keys[index] = std::move(donor->keys[0]);
+        parent->prefixes[index] = donor->prefixes[0];
+        for (unsigned int i = 0; i + 1 < donor->count; i++) {
+            donor->keys[i] = std::move(donor->keys[i + 1]);
+            donor->prefixes[i] = donor->prefixes[i + 1];
+            donor->children[i] = donor->children[i + 1];
+        }
+        donor->children[donor->count - 1] = donor->children[donor->count];
+        donor->count--;
+        return;
+    }
+
+    // Merges the right one of the pair, and the separator between them, into the left one
+    unsigned int leftIndex = left != nullptr ? index - 1 : index;
+    InnerNode* into = static_cast<InnerNode*>(parent->children[leftIndex]);
+    InnerNode* from = static_cast<InnerNode*>(parent->children[leftIndex + 1]);
+    into->keys[into->count] = std::move(parent->keys[leftIndex]);
+    into->prefixes[into->count] = parent->prefixes[leftIndex];
+    into->count++;
+    for (unsigned int i = 0; i < from->count; i++) {
+        into->keys[into->count + i] = std::move(from->keys[i]);
+        into->prefixes[into->count + i] = from->prefixes[i];
+        into->children[into->count + i] = from->children[i];
+    }
+    into->children[into->count + from->count] = from->children[from->count];
+    into->count += from->count;
+
+    delete from;
+    eraseFromInner(parent, leftIndex);
 }
 
+/**
+ * Returns the number of bids in the tree
+ */
+size_t BPlusTree::Size() {
+    return size;
+}
 
+/**
+ * Returns the number of levels in the tree, counting the leaves
+ */
+int BPlusTree::Height() {
+    return levels;
+}
 
 //============================================================================
 // Static methods used for testing
@@ -353,13 +4013,31 @@ void displayBid(Bid bid) {
     return;
 }
 
+/**
+ * Move a frozen snapshot's bids back into the binary search tree, if there is one
+ *
+ * @param bst The tree to thaw into
+ * @param frozenTree The snapshot, freed and reset to null
+ */
+void thawIfFrozen(BinarySearchTree* bst, FrozenBidTree*& frozenTree) {
+    if (frozenTree == nullptr) {
+        return;
+    }
+
+    bst->Thaw(frozenTree);
+    delete frozenTree;
+    frozenTree = nullptr;
+    cout << "Binary search tree thawed" << endl;
+}
+
 /**
  * Load a CSV file containing bids into a container
  *
  * @param csvPath the path to the CSV file to load
  * @return a container holding all the bids read
  */
-void loadBids(string csvPath, BinarySearchTree* bst) {
+template <typename Tree>
+void loadBids(string csvPath, Tree* bst) {
     cout << "Loading CSV file " << csvPath << endl;
 
     // initialize the CSV Parser using the given path
@@ -372,6 +4050,10 @@ void loadBids(string csvPath, BinarySearchTree* bst) {
     }
     cout << "" << endl;
 
+    // Collects the rows first so the tree can be built from all of them at once
+    vector<Bid> bids;
+    bids.reserve(file.rowCount());
+
     try {
         // loop to read rows of a CSV file
         for (unsigned int i = 0; i < file.rowCount(); i++) {
@@ -386,11 +4068,14 @@ void loadBids(string csvPath, BinarySearchTree* bst) {
             //cout << "Item: " << bid.title << ", Fund: " << bid.fund << ", Amount: " << bid.amount << endl;
 
             // push this bid to the end
-            bst->Insert(bid);
+            bids.push_back(bid);
         }
     } catch (csv::Error &e) {
         std::cerr << e.what() << std::endl;
     }
+
+    // Adds every bid read in one pass
+    bst->BulkLoad(std::move(bids));
 }
 
 /**
@@ -406,6 +4091,98 @@ double strToDouble(string str, char ch) {
     return atof(str.c_str());
 }
 
+#ifdef BST_SELF_TEST
+
+//============================================================================
+// Self-tests, built in place of the menu with -DBST_SELF_TEST
+// (and without NDEBUG, so the asserts are active)
+//============================================================================
+
+/**
+ * Run readers against a writer that keeps removing and re-inserting bids
+ * Half of the ids stay in the tree throughout and must always be found;
+ * the other half churn, and a reader that finds one must get its own bid.
+ *
+ * @param bidCount The number of ids in the tree
+ * @param rounds The number of times the writer removes and re-inserts the churning ids
+ * @return The number of wrong answers the readers saw, 0 on success
+ */
+size_t stressConcurrentTree(size_t bidCount, unsigned int rounds) {
+    ConcurrentBidTree tree;
+
+    // Loads every id, the even positions stable and the odd ones churning
+    vector<Bid> bids(bidCount);
+    for (size_t i = 0; i < bidCount; i++) {
+        bids[i].bidId = to_string(100000 + i);
+        bids[i].title = "Bid " + bids[i].bidId;
+        bids[i].amount = static_cast<double>(i);
+    }
+    tree.BulkLoad(bids);
+
+    atomic<bool> writing{true};
+    atomic<size_t> errors{0};
+    atomic<size_t> lookups{0};
+
+    // Starts the readers, one per hardware thread beyond the writer's
+    unsigned int readerCount = max(3u, thread::hardware_concurrency()) - 1;
+    vector<thread> readers;
+    for (unsigned int t = 0; t < readerCount; t++) {
+        readers.emplace_back([&, t]() {
+            mt19937 random(t);
+            size_t done = 0;
+            while (writing.load()) {
+                size_t i = random() % bidCount;
+                Bid found = tree.Search(bids[i].bidId);
+                bool missing = found.bidId.empty();
+                if ((missing && i % 2 == 0) || (!missing && found.title != bids[i].title)) {
+                    errors++;
+                }
+                done++;
+            }
+            lookups += done;
+        });
+    }
+
+    // Removes and re-inserts the churning ids, in a different order each round
+    mt19937 random(rounds);
+    vector<size_t> churning;
+    for (size_t i = 1; i < bidCount; i += 2) {
+        churning.push_back(i);
+    }
+    for (unsigned int round = 0; round < rounds; round++) {
+        shuffle(churning.begin(), churning.end(), random);
+        for (size_t i : churning) {
+            tree.Remove(bids[i].bidId);
+        }
+        shuffle(churning.begin(), churning.end(), random);
+        for (size_t i : churning) {
+            tree.Insert(bids[i]);
+        }
+    }
+
+    writing.store(false);
+    for (thread& reader : readers) {
+        reader.join();
+    }
+
+    cout << readerCount << " readers, " << lookups.load() << " lookups, " << tree.FreedNodes()
+        << " nodes freed, " << errors.load() << " wrong answers" << endl;
+    return errors.load();
+}
+
+/**
+ * Run every self-test, stopping at the first failed assert
+ */
+int main() {
+    // Checks that lock-free readers stay correct while nodes are removed and freed under them
+    assert(stressConcurrentTree(100000, 20) == 0);
+
+    cout << "All self-tests passed" << endl;
+    return 0;
+}
+
+#else
+
 /**
  * The one and only main() method
  */
@@ -433,6 +4210,25 @@ int main(int argc, char* argv[]) {
     // Define a binary search tree to hold all bids
     BinarySearchTree* bst;
     bst = new BinarySearchTree();
+    // Answers most lookups of missing ids without walking the tree
+    bst->EnableBloomFilter(0.01);
+    // Keeps the tree balanced, the CSV files are sorted by id and would otherwise form a list
+    bst->SetBalanced(true);
+    // Define a B+ tree as a cache-friendlier alternative index
+    BPlusTree* bPlusTree = new BPlusTree();
+    // Define a balanced tree comparing numeric bid ids as integers
+    NumericBidTree* numericTree = new NumericBidTree();
+    // Define a path-copying tree whose versions can be snapshotted in O(1)
+    PersistentBidTree* persistentTree = new PersistentBidTree();
+    // Define an adaptive radix tree, which branches on the id's bytes instead of comparing ids
+    RadixBidIndex* radixTree = new RadixBidIndex();
+    // Define a lock-free skip list, loaded by several threads at once
+    SkipListBidIndex* skipList = new SkipListBidIndex();
+    // Selects which of the trees the menu operates on (0 = binary search tree, 1 = B+ tree,
+    // 2 = integer-keyed tree, 3 = persistent tree, 4 = radix tree, 5 = skip list)
+    int treeType = 0;
+    // Holds the binary search tree's bids while it is frozen for lookups, null otherwise
+    FrozenBidTree* frozenTree = nullptr;
     Bid bid;
 
     int choice = 0;
@@ -442,6 +4238,9 @@ int main(int argc, char* argv[]) {
         cout << "  2. Display All Bids" << endl;
         cout << "  3. Find Bid" << endl;
         cout << "  4. Remove Bid" << endl;
+        cout << "  5. Switch Tree Type" << endl;
+        cout << "  6. Display Bids in Id Range" << endl;
+        cout << "  7. Freeze/Thaw Binary Search Tree" << endl;
         cout << "  9. Exit" << endl;
         cout << "Enter choice: ";
         cin >> choice;
@@ -454,9 +4253,32 @@ int main(int argc, char* argv[]) {
             ticks = clock();
 
             // Complete the method call to load the bids
-            loadBids(csvPath, bst);
+            if (treeType == 1) {
+                loadBids(csvPath, bPlusTree);
+                cout << bPlusTree->Size() << " bids read" << endl;
+                cout << "tree height: " << bPlusTree->Height() << endl;
+            } else if (treeType == 2) {
+                loadBids(csvPath, numericTree);
+                cout << numericTree->Size() << " bids read" << endl;
+                cout << "tree height: " << numericTree->Height() << endl;
+            } else if (treeType == 3) {
+                loadBids(csvPath, persistentTree);
+                cout << persistentTree->Size() << " bids read" << endl;
+                cout << "tree height: " << persistentTree->Height() << endl;
+            } else if (treeType == 4) {
+                loadBids(csvPath, radixTree);
+                cout << radixTree->Size() << " bids read" << endl;
+                cout << "node memory: " << radixTree->MemoryUsage() << " bytes" << endl;
+            } else if (treeType == 5) {
+                loadBids(csvPath, skipList);
+                cout << skipList->Size() << " bids read" << endl;
+            } else {
+                thawIfFrozen(bst, frozenTree);
+                loadBids(csvPath, bst);
 
-            //cout << bst->Size() << " bids read" << endl;
+                //cout << bst->Size() << " bids read" << endl;
+                cout << "tree height: " << bst->Height() << endl;
+            }
 
             // Calculate elapsed time and display result
             ticks = clock() - ticks; // current clock ticks minus starting clock ticks
@@ -465,6 +4287,33 @@ int main(int argc, char* argv[]) {
             break;
 
         case 2:
+            if (treeType == 1) {
+                bPlusTree->InOrder();
+                break;
+            }
+            if (treeType == 2) {
+                numericTree->InOrder();
+                break;
+            }
+            if (treeType == 3) {
+                // Lists a snapshot, which later edits to the tree cannot change mid-report
+                BidTreeSnapshot snapshot = persistentTree->Snapshot();
+                snapshot.InOrder();
+                cout << snapshot.Size() << " bids in snapshot" << endl;
+                break;
+            }
+            if (treeType == 4) {
+                radixTree->InOrder();
+                break;
+            }
+            if (treeType == 5) {
+                skipList->InOrder();
+                break;
+            }
+            if (frozenTree != nullptr) {
+                frozenTree->InOrder();
+                break;
+            }
             bst->InOrder();
             //bst->PostOrder();
             //bst->PreOrder();
@@ -473,7 +4322,21 @@ int main(int argc, char* argv[]) {
         case 3:
             ticks = clock();
 
-            bid = bst->Search(bidKey);
+            if (treeType == 1) {
+                bid = bPlusTree->Search(bidKey);
+            } else if (treeType == 2) {
+                bid = numericTree->Search(bidKey);
+            } else if (treeType == 3) {
+                bid = persistentTree->Search(bidKey);
+            } else if (treeType == 4) {
+                bid = radixTree->Search(bidKey);
+            } else if (treeType == 5) {
+                bid = skipList->Search(bidKey);
+            } else if (frozenTree != nullptr) {
+                bid = frozenTree->Search(bidKey);
+            } else {
+                bid = bst->Search(bidKey);
+            }
 
             ticks = clock() - ticks; // current clock ticks minus starting clock ticks
 
@@ -483,14 +4346,96 @@ int main(int argc, char* argv[]) {
             	cout << "Bid Id " << bidKey << " not found." << endl;
             }
 
+            if (treeType == 0) {
+                cout << "probes avoided by the Bloom filter: " << bst->BloomAvoidedProbes() << endl;
+            }
+
             cout << "time: " << ticks << " clock ticks" << endl;
             cout << "time: " << ticks * 1.0 / CLOCKS_PER_SEC << " seconds" << endl;
 
             break;
 
         case 4:
-            bst->Remove(bidKey);
+            if (treeType == 1) {
+                bPlusTree->Remove(bidKey);
+            } else if (treeType == 2) {
+                numericTree->Remove(bidKey);
+            } else if (treeType == 3) {
+                persistentTree->Remove(bidKey);
+            } else if (treeType == 4) {
+                radixTree->Remove(bidKey);
+            } else if (treeType == 5) {
+                skipList->Remove(bidKey);
+            } else {
+                thawIfFrozen(bst, frozenTree);
+                bst->Remove(bidKey);
+            }
+            break;
+
+        case 5:
+            // Cycles through the binary search tree, the B+ tree, the integer-keyed tree,
+            // the persistent tree, the radix tree and the skip list
+            treeType = (treeType + 1) % 6;
+            cout << "Using " << (treeType == 1 ? "B+ tree" : treeType == 2 ? "integer-keyed tree"
+                : treeType == 3 ? "persistent tree" : treeType == 4 ? "radix tree"
+                : treeType == 5 ? "skip list" : "binary search tree") << endl;
+            break;
+
+        case 6:
+            // The radix tree answers prefix queries, the ids sharing a prefix form a range
+            if (treeType == 4) {
+                string prefix;
+                cout << "Enter id prefix: ";
+                cin >> prefix;
+
+                vector<Bid> bids = radixTree->PrefixScan(prefix);
+                for (const Bid& prefixBid : bids) {
+                    displayBid(prefixBid);
+                }
+                cout << bids.size() << " bids with ids starting with " << prefix << endl;
+                break;
+            }
+
+            // Range queries use the subtree sizes kept by the binary search tree only
+            if (treeType != 0) {
+                cout << "Range queries are only available for the binary search tree" << endl;
+                break;
+            }
+
+            thawIfFrozen(bst, frozenTree);
+
+            // Prompts for the id range and displays only the bids within it
+            {
+                string lowId, highId;
+                cout << "Enter lowest id: ";
+                cin >> lowId;
+                cout << "Enter highest id: ";
+                cin >> highId;
+
+                vector<Bid> bids = bst->RangeScan(lowId, highId);
+                for (const Bid& rangeBid : bids) {
+                    displayBid(rangeBid);
+                }
+                cout << bids.size() << " bids in range, " << bst->Rank(lowId) << " of " << bst->Size()
+                    << " bids come before it" << endl;
+
+                // Displays the range's amount totals, taken from the tree's cached subtree totals
+                AmountSummary summary = bst->SummarizeAmounts(lowId, highId);
+                cout << "total: " << summary.total << " | min: " << summary.minimum << " | max: "
+                    << summary.maximum << endl;
+            }
+            break;
+
+        case 7:
+            // Switches the binary search tree between its mutable and read-optimized forms
+            if (frozenTree != nullptr) {
+                thawIfFrozen(bst, frozenTree);
+            } else {
+                frozenTree = bst->Freeze();
+                cout << "Binary search tree frozen, " << frozenTree->Size() << " bids in Eytzinger order" << endl;
+            }
             break;
+
         case 9:
             break;
         default:
@@ -506,3 +4451,5 @@ int main(int argc, char* argv[]) {
 
 	return 0;
 }
+
+#endif // BST_SELF_TEST
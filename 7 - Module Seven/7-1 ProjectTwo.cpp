@@ -13,8 +13,17 @@
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../OrderedMap.hpp"
+
 using namespace std;
 
+// Largest catalog whose transitive closure is precomputed, 16384 courses take 32 MB of bits
+const size_t MAX_CLOSURE_COURSES = 16384;
+
 // Structure for the course object
 struct Course {
     string number;
@@ -22,29 +31,6 @@ struct Course {
     vector<string> preReqs;
 };
 
-// Structure for the tree nodes objects
-struct Node {
-    // Initializes the course var and the pointer vars
-    Course course;
-    Node* right;
-    Node* left;
-
-    // Default constructor
-    Node() {
-        // Point both vars to null
-        right = nullptr;
-        left = nullptr;
-    }
-
-    // Initializing with a newCourse
-    Node(Course newCourse) :
-        // Call the default constructor
-        Node() {
-        // Set course to the passed in course
-        course = newCourse;
-    }
-};
-
 void printCourse(Course course, bool showPreReqs) {
     // Displays the course number and name
     cout << course.number << ", " << course.name << endl;
@@ -80,43 +66,49 @@ void printCourse(Course course, bool showPreReqs) {
     }
 }
 
+/**
+ * Converts a course number to the uppercase key it is stored under,
+ * so letters are compared regardless of case
+ *
+ * @param courseNumber - Course number as entered or read from the file
+ * @return string - The uppercase course number
+ */
+string courseKey(string courseNumber) {
+    transform(courseNumber.begin(), courseNumber.end(), courseNumber.begin(), ::toupper);
+    return courseNumber;
+};
+
+/**
+ * Binary search tree of courses keyed by course number.
+ * The tree itself is the shared AVL-balanced OrderedMap, so loading a
+ * catalog sorted by course number no longer degrades it into a list.
+ */
 class BinarySearchTree {
 
 private:
-    // Points to the first node of the tree
-    Node* root;
+    // Holds the courses keyed by their uppercase course number
+    OrderedMap<string, Course> courses;
 
-    Node* removeNode(Node* node, string courseNumber);
-    void addNode(Node* node, Course course);
-    void inOrder(Node* node);
 public:
     BinarySearchTree();
     virtual ~BinarySearchTree();
     void Insert(Course course);
     void Search(string courseNumber);
     void DisplayAll();
+    template <typename Visit> void ForEach(Visit visit);
 };
 
 /**
  * Default constructor for the BinarySerachTree class
  */
 BinarySearchTree::BinarySearchTree() {
-    root = nullptr;
 };
 
 /**
  * Default de-constructor for the BinarySerachTree class
  */
 BinarySearchTree::~BinarySearchTree() {
-    // Initializes a new pointer and points it to the root of the tree
-    Node* currNode = nullptr;
-
-    // Loops through all nodes within the tree
-    while (currNode != nullptr) {
-        // Calls the removeNode method and it returns the next node in line for the tree
-            // currNode is set to the next node until all tree nodes are removed
-        currNode = removeNode(currNode, currNode->course.number);
-    }
+    // The courses are freed with the map
 };
 
 /**
@@ -126,15 +118,9 @@ BinarySearchTree::~BinarySearchTree() {
  * @return void
  */
 void BinarySearchTree::Insert (Course course) {
-    // Check if the tree's root is pointing to null
-    if (root == nullptr) {
-        // Initialize a new node and point the root to it
-        root = new Node(course);
-    }
-    else {
-        // Call the addNode method to add the course to the tree
-        addNode(root, course);
-    }
+    // Stores the course under its uppercase number, replacing any course with the same number
+    string key = courseKey(course.number);
+    courses.Insert(std::move(key), std::move(course));
 };
 
 /**
@@ -144,34 +130,14 @@ void BinarySearchTree::Insert (Course course) {
  * @return void
  */
 void BinarySearchTree::Search (string courseNumber) {
-    // Initializes a pointer and points it to the root of the tree
-    Node* currNode = root;
-
-    // Converts the passed in string to uppercase, to compare letters not characters
-    transform(courseNumber.begin(), courseNumber.end(), courseNumber.begin(), ::toupper);
-
-    // Traverses the tree until the associated node is found or a null pointer is reached
-    while (currNode != nullptr) {
-        // Initializes a local var to hold the current course's number
-        string currCourseNumber = currNode->course.number;
-
-        // Converts the current course's number to uppercase, to ensure consistency when comparing
-        transform(currCourseNumber.begin(), currCourseNumber.end(), currCourseNumber.begin(), ::toupper);
+    // Looks the course up by its uppercase number, to compare letters not characters
+    const Course* course = courses.Find(courseKey(courseNumber));
 
-        // Compares the current node's course number to the passed in course number
-        if (currCourseNumber == courseNumber) { // Indicates the associated node is found
-            // Calls print course function with the flag to print prerequisites info
-            printCourse(currNode->course, true);
-            return;
-        }
-        else if (currNode->course.number > courseNumber) { // Indicates the associated node should be to the left of the current node
-            // Navigates to the left child of the current node
-            currNode = currNode->left;
-        }
-        else { // Indicates the associated node should be to the right of the current node
-            // Navigates to the right child of the current node
-            currNode = currNode->right;
-        }
+    // Checks if the associated course was found
+    if (course != nullptr) {
+        // Calls print course function with the flag to print prerequisites info
+        printCourse(*course, true);
+        return;
     }
 
     // Display a message indicating the passed in courseNumber is not associated with any course nodes
@@ -179,159 +145,374 @@ void BinarySearchTree::Search (string courseNumber) {
 };
 
 /**
- * Displays all elements in the tree starting from the root node
+ * Displays all elements in the tree in alphanumeric order
  * 
  * @return void
  */
 void BinarySearchTree::DisplayAll() {
-    // Call the inOrder method to start from the root of the tree
-    inOrder(root);
+    // Visits every course in key order, disabling the flag to show prerequisites
+    courses.ForEach([](const string&, const Course& course) {
+        printCourse(course, false);
+    });
 };
 
 /**
- * Recursive method to removes the node associated with the passed in courseNumber
- * and returns the to-be removed node's successive node, or null if there is no successive node.
- * 
- * @param node - Pointer to the current node 
- * @param courseNumber - String value to indicate which node is to be removed
- * @return Node* - Returns a pointer to the removed node's successive node, or null if none exists.
+ * Calls the visit function for every course in alphanumeric order
+ *
+ * @param visit - Function taking a const Course&
+ * @return void
  */
-Node* BinarySearchTree::removeNode(Node* node, string courseNumber) {
-    // Checks if node is pointing to null or compare the current node's course number to the to-be removed course number
-    if (node == nullptr) {
-        // Return the null value
-        return node;
-    }
-    else if (node->course.number > courseNumber) { // Indicates that the to-be removed node is positioned to the left of the current node.
-        // Recursively call the method to search the left path
-            // the successive node of the to-be removed node or null will be returned which will be set to the current node's left pointer
-        node->left = removeNode(node->left, courseNumber);
+template <typename Visit>
+void BinarySearchTree::ForEach(Visit visit) {
+    courses.ForEach([&visit](const string&, const Course& course) {
+        visit(course);
+    });
+};
+
+/**
+ * Graph of the prerequisites between the loaded courses.
+ * Each course gets an integer id in alphanumeric order, and the edges are
+ * stored in compressed sparse row form: the prerequisites of course i are
+ * prereqTargets[prereqOffsets[i]] up to prereqTargets[prereqOffsets[i + 1]],
+ * with the reverse edges to dependent courses kept the same way. The
+ * transitive closure is precomputed as one row of bits per course, built in
+ * topological order by OR-ing the rows of each course's prerequisites a
+ * 64-bit word at a time, so checking whether one course is required before
+ * another is a single bit test.
+ */
+class PrerequisiteGraph {
+
+private:
+    // Holds each id's course number, and each uppercase course number's id
+    vector<string> courseNumbers;
+    unordered_map<string, int> courseIds;
+
+    // Holds the edges from each course to its direct prerequisites and to its direct dependents
+    vector<int> prereqOffsets;
+    vector<int> prereqTargets;
+    vector<int> dependentOffsets;
+    vector<int> dependentTargets;
+
+    // Holds each course's row of transitively required courses, empty for very large catalogs
+    vector<uint64_t> closure;
+    size_t wordsPerRow = 0;
+
+    // Holds one prerequisite cycle's course ids, empty if there is none
+    vector<int> cycle;
+
+    void findCycle(const vector<int>& remaining);
+    vector<int> reachable(int courseId, const vector<int>& offsets, const vector<int>& targets) const;
+    vector<string> toNumbers(const vector<int>& ids) const;
+public:
+    void Build(BinarySearchTree* courses);
+    bool Contains(string courseNumber) const;
+    bool Requires(string courseNumber, string prereqNumber) const;
+    bool AllPrerequisites(string courseNumber, vector<string>& prereqs) const;
+    bool Unlocks(string courseNumber, vector<string>& dependents) const;
+    vector<string> Cycle() const;
+};
+
+/**
+ * Builds the graph, and the closure for catalogs up to MAX_CLOSURE_COURSES, from the loaded courses
+ *
+ * @param courses - Binary search tree holding the loaded courses
+ * @return void
+ */
+void PrerequisiteGraph::Build(BinarySearchTree* courses) {
+    // Clears any graph built from an earlier load
+    courseNumbers.clear();
+    courseIds.clear();
+    prereqOffsets.assign(1, 0);
+    prereqTargets.clear();
+    closure.clear();
+    cycle.clear();
+
+    // Assigns every course an id in alphanumeric order
+    courses->ForEach([this](const Course& course) {
+        courseIds[courseKey(course.number)] = static_cast<int>(courseNumbers.size());
+        courseNumbers.push_back(course.number);
+    });
+    int numCourses = courseNumbers.size();
+
+    // Lays out each course's prerequisites one course after another
+    courses->ForEach([this](const Course& course) {
+        for (const string& preReq : course.preReqs) {
+            auto found = courseIds.find(courseKey(preReq));
+            if (found != courseIds.end()) {
+                prereqTargets.push_back(found->second);
+            }
+        }
+        prereqOffsets.push_back(static_cast<int>(prereqTargets.size()));
+    });
+
+    // Builds the reverse edges by counting each course's dependents, then placing them
+    dependentOffsets.assign(numCourses + 1, 0);
+    for (int target : prereqTargets) {
+        dependentOffsets[target + 1]++;
     }
-    else if (node->course.number < courseNumber) { // Indicates that the to-be removed node is positioned to the right of the current node.
-        // Recursively call the method to search the right path
-            // the successive node of the to-be removed node or null will be returned which will be set to the current node's left pointer
-        node->right = removeNode(node->right, courseNumber);
+    for (int id = 0; id < numCourses; id++) {
+        dependentOffsets[id + 1] += dependentOffsets[id];
     }
-    else { // Indicates the current node is the to-be removed node
-        // Check if the current node has any child nodes
-        if (node->left == nullptr && node->right == nullptr) { // Indicates no child nodes
-            // Deletes the current node and points the node pointer to null
-            delete node;
-            node = nullptr;
+    dependentTargets.assign(prereqTargets.size(), 0);
+    vector<int> nextSlot(dependentOffsets.begin(), dependentOffsets.end() - 1);
+    for (int id = 0; id < numCourses; id++) {
+        for (int edge = prereqOffsets[id]; edge < prereqOffsets[id + 1]; edge++) {
+            dependentTargets[nextSlot[prereqTargets[edge]]++] = id;
         }
-        else if (node->left != nullptr && node->right == nullptr) { // Indicates there is a left child node
-            // Initializes a pointer and points it to the node pointer
-            Node* removedNode = node;
-            // Points the node pointer to the current node's left child
-            node = node->left;
-            // Deletes the current node
-            delete removedNode;
-            // Points the current node to null
-            removedNode = nullptr;
+    }
+
+    // Orders the courses so each comes after all of its prerequisites, starting with those that have none
+    vector<int> remaining(numCourses);
+    vector<int> order;
+    order.reserve(numCourses);
+    for (int id = 0; id < numCourses; id++) {
+        remaining[id] = prereqOffsets[id + 1] - prereqOffsets[id];
+        if (remaining[id] == 0) {
+            order.push_back(id);
         }
-        else if (node->left == nullptr && node->right != nullptr) { // Indicates there is a right child
-            // Initializes a pointer and points it to the node pointer
-            Node* removedNode = node;
-            // Points the node pointer to the current node's right child
-            node = node->right;
-            // Deletes the current node
-            delete removedNode;
-            // Points the current node to null
-            removedNode = nullptr;
+    }
+    for (size_t index = 0; index < order.size(); index++) {
+        int id = order[index];
+        for (int edge = dependentOffsets[id]; edge < dependentOffsets[id + 1]; edge++) {
+            if (--remaining[dependentTargets[edge]] == 0) {
+                order.push_back(dependentTargets[edge]);
+            }
         }
-        else { // Indicates the current node has both child nodes
-            // Initializes a pointer and points to the current node's right child
-            Node* succNode = node->right;
-            // Traverse's the right child's left path until the current node's successor is found
-            while (succNode->left != nullptr) {
-                succNode = succNode->left;
+    }
+
+    // Courses left out of the order are on, or depend on, a prerequisite cycle
+    if (static_cast<int>(order.size()) < numCourses) {
+        findCycle(remaining);
+    }
+
+    // Checks if the catalog is small enough to precompute the closure
+    if (numCourses == 0 || numCourses > static_cast<int>(MAX_CLOSURE_COURSES)) {
+        return;
+    }
+    wordsPerRow = (numCourses + 63) / 64;
+    closure.assign(numCourses * wordsPerRow, 0);
+
+    // Fills each row from its prerequisites' finished rows, a word at a time
+    for (int id : order) {
+        uint64_t* row = &closure[id * wordsPerRow];
+        for (int edge = prereqOffsets[id]; edge < prereqOffsets[id + 1]; edge++) {
+            int preReq = prereqTargets[edge];
+            const uint64_t* preReqRow = &closure[preReq * wordsPerRow];
+            for (size_t word = 0; word < wordsPerRow; word++) {
+                row[word] |= preReqRow[word];
             }
-            // Initializes a local var to store the successor's course data
-            Course succNodeCourseData = succNode->course;
-            // Sets the current node's course data to the successor's course data
-            node->course = succNodeCourseData;
-            // Recursively calls the function to remove the successor node from the tree, starting from the current node's right child
-            removeNode(node->right, succNodeCourseData.number);
+            row[preReq / 64] |= 1ULL << (preReq % 64);
         }
     }
 
-    // Returns the current node pointer
-    return node;
+    // Fills the rows of courses caught up in a cycle by searching the graph instead
+    for (int id = 0; id < numCourses; id++) {
+        if (remaining[id] > 0) {
+            for (int preReq : reachable(id, prereqOffsets, prereqTargets)) {
+                closure[id * wordsPerRow + preReq / 64] |= 1ULL << (preReq % 64);
+            }
+        }
+    }
 };
 
 /**
- * Traverses through the tree along the appropriate path relative to the course's course number.
- * The method recursively calls itself until an empty position in the tree is found
+ * Records one prerequisite cycle among the courses the topological order left out.
+ * Every such course has a prerequisite that was also left out, so following
+ * those from any of them must come back to a course already visited.
  *
- * @param node - Pointer to a node in the binary search tree
- * @param course - Course object that will be added to the tree
+ * @param remaining - Each course's count of prerequisites not yet ordered
  * @return void
  */
-void BinarySearchTree::addNode(Node* node, Course course) {
-    // Compare the current node's course number to new course's number
-    if (node->course.number > course.number) { // Indicates the new course should be inserted to the left of the current node
-        // Check if the current node's left child is not occupied
-        if (node->left == nullptr) {
-            // Initializes a new node and points the current node's left pointer to it
-            node->left = new Node(course);
-        }
-        else {
-            // Recursively calls the method to insert the new course to the left path of the current node
-            addNode(node->left, course);
+void PrerequisiteGraph::findCycle(const vector<int>& remaining) {
+    int numCourses = courseNumbers.size();
+    vector<int> visitedAt(numCourses, -1);
+    vector<int> path;
+
+    // Starts from the first course left out
+    int id = 0;
+    while (remaining[id] == 0) {
+        id++;
+    }
+
+    // Follows left-out prerequisites until a course on the path repeats
+    while (visitedAt[id] < 0) {
+        visitedAt[id] = static_cast<int>(path.size());
+        path.push_back(id);
+        for (int edge = prereqOffsets[id]; edge < prereqOffsets[id + 1]; edge++) {
+            if (remaining[prereqTargets[edge]] > 0) {
+                id = prereqTargets[edge];
+                break;
+            }
         }
     }
-    else { // Indicates the new course should be inserted to the right of the current node
-        // Check if the current node's right child is not occupied
-        if (node->right == nullptr) {
-            // Initializes a new node and points the current node's left pointer to it
-            node->right = new Node(course);
+
+    // Keeps the path from the repeated course on, and closes the loop
+    cycle.assign(path.begin() + visitedAt[id], path.end());
+    cycle.push_back(id);
+};
+
+/**
+ * Finds every course reachable from a course along the given edges
+ *
+ * @param courseId - Id of the course to start from, which is only included if it is on a cycle
+ * @param offsets - Edge offsets of either edge direction
+ * @param targets - Edge targets of the same direction
+ * @return vector<int> - The reachable course ids in ascending order
+ */
+vector<int> PrerequisiteGraph::reachable(int courseId, const vector<int>& offsets, const vector<int>& targets) const {
+    vector<bool> seen(courseNumbers.size(), false);
+    vector<int> pending(1, courseId);
+    vector<int> found;
+
+    while (!pending.empty()) {
+        int id = pending.back();
+        pending.pop_back();
+        for (int edge = offsets[id]; edge < offsets[id + 1]; edge++) {
+            if (!seen[targets[edge]]) {
+                seen[targets[edge]] = true;
+                found.push_back(targets[edge]);
+                pending.push_back(targets[edge]);
+            }
         }
-        else {
-            // Recursively calls the method to insert the new course to the right path of the current node
-            addNode(node->right, course);
+    }
+
+    sort(found.begin(), found.end());
+    return found;
+};
+
+/**
+ * Converts course ids to their course numbers
+ */
+vector<string> PrerequisiteGraph::toNumbers(const vector<int>& ids) const {
+    vector<string> numbers;
+    numbers.reserve(ids.size());
+    for (int id : ids) {
+        numbers.push_back(courseNumbers[id]);
+    }
+    return numbers;
+};
+
+/**
+ * Checks if a course is in the catalog
+ *
+ * @param courseNumber - Course number to look up
+ * @return bool - True if the course was loaded
+ */
+bool PrerequisiteGraph::Contains(string courseNumber) const {
+    return courseIds.count(courseKey(courseNumber)) > 0;
+};
+
+/**
+ * Checks if a course must be taken, directly or indirectly, before another
+ *
+ * @param courseNumber - Course number of the later course
+ * @param prereqNumber - Course number of the possible prerequisite
+ * @return bool - True if prereqNumber is a transitive prerequisite of courseNumber
+ */
+bool PrerequisiteGraph::Requires(string courseNumber, string prereqNumber) const {
+    auto course = courseIds.find(courseKey(courseNumber));
+    auto preReq = courseIds.find(courseKey(prereqNumber));
+    if (course == courseIds.end() || preReq == courseIds.end()) {
+        return false;
+    }
+
+    // Tests a single bit when the closure is precomputed
+    if (!closure.empty()) {
+        return (closure[course->second * wordsPerRow + preReq->second / 64] >> (preReq->second % 64)) & 1;
+    }
+    vector<int> preReqs = reachable(course->second, prereqOffsets, prereqTargets);
+    return binary_search(preReqs.begin(), preReqs.end(), preReq->second);
+};
+
+/**
+ * Lists every course required, directly or indirectly, before a course
+ *
+ * @param courseNumber - Course number to look up
+ * @param prereqs - Filled with the prerequisites' course numbers in alphanumeric order
+ * @return bool - False if the course is not in the catalog
+ */
+bool PrerequisiteGraph::AllPrerequisites(string courseNumber, vector<string>& prereqs) const {
+    auto course = courseIds.find(courseKey(courseNumber));
+    if (course == courseIds.end()) {
+        return false;
+    }
+
+    // Walks the set bits of the course's closure row, a word at a time
+    if (!closure.empty()) {
+        vector<int> ids;
+        const uint64_t* row = &closure[course->second * wordsPerRow];
+        for (size_t word = 0; word < wordsPerRow; word++) {
+            for (uint64_t bits = row[word]; bits != 0; bits &= bits - 1) {
+                int bit = 0;
+                while (((bits >> bit) & 1) == 0) {
+                    bit++;
+                }
+                ids.push_back(static_cast<int>(word * 64 + bit));
+            }
         }
+        prereqs = toNumbers(ids);
+        return true;
     }
+
+    prereqs = toNumbers(reachable(course->second, prereqOffsets, prereqTargets));
+    return true;
 };
 
 /**
- * Displays the course info in the current node after recursively calling the method for the left child
- * and before recursively calling the method for the right child
+ * Lists every course that requires, directly or indirectly, a course
  *
- * @param node - Pointer to a node in the binary search tree
- * @return void
+ * @param courseNumber - Course number to look up
+ * @param dependents - Filled with the unlocked courses' numbers in alphanumeric order
+ * @return bool - False if the course is not in the catalog
  */
-void BinarySearchTree::inOrder(Node* node) {
-    // Check if the node pointer is pointing to null
-    if (node == nullptr) {
-        // Exit the method
-        return;
+bool PrerequisiteGraph::Unlocks(string courseNumber, vector<string>& dependents) const {
+    auto course = courseIds.find(courseKey(courseNumber));
+    if (course == courseIds.end()) {
+        return false;
     }
 
-    // Recursively call the method for the current node's left child
-    inOrder(node->left);
-    // Call the print course function, and disable the flag to show prerequisites
-    printCourse(node->course, false);
-    // Recursively call the method for the current node's right child
-    inOrder(node->right);
+    dependents = toNumbers(reachable(course->second, dependentOffsets, dependentTargets));
+    return true;
+};
+
+/**
+ * Returns one prerequisite cycle as course numbers, the first repeated at the end,
+ * or an empty vector if the prerequisites have no cycle
+ */
+vector<string> PrerequisiteGraph::Cycle() const {
+    return toNumbers(cycle);
 };
 
 /**
  * Parses file lines into separate strings.
  * Each string is split using a ','
+ * The course numbers are gathered into a hash set first, so each prerequisite
+ * is validated with a single lookup and the whole file is parsed in linear time.
  *
- * @param courseData - Data gathered from reading each line of the file
+ * @param courseData - Data gathered from reading each line of the file, its strings are moved into the courses
  * @return void
  */
-void parseFileData(vector<vector<string>> courseData, BinarySearchTree* courses) {
+void parseFileData(vector<vector<string>>& courseData, BinarySearchTree* courses) {
     try {
 
         // Initializes a variable to store the number of rows from the courseData file
         int courseFileSize = courseData.size();
 
+        // Initializes a hash set holding every course number listed in the file
+        unordered_set<string> courseNumbers;
+        courseNumbers.reserve(courseFileSize);
+        for (const vector<string>& row : courseData) {
+            // Checks the row has a course number to add
+            if (!row.empty()) {
+                courseNumbers.insert(row[0]);
+            }
+        }
+
         // Iterates through the courseData vector
         for (int rowNum = 0; rowNum < courseFileSize; rowNum++) {
-            // Initializes a variable to store the current row's number of parameters
-            int rowLength = courseData[rowNum].size();
+            // Initializes a reference to the current row and a variable to store its number of parameters
+            vector<string>& row = courseData[rowNum];
+            int rowLength = row.size();
 
             // Checks if the current row has the minimum number of parameters
             if (rowLength < 2) {
@@ -346,51 +527,33 @@ void parseFileData(vector<vector<string>> courseData, BinarySearchTree* courses)
                 throw std::runtime_error(errorMessage.str());
             }
 
-            // Initializes a new course object and assigns the number and name for the course
-            Course newCourse;
-            newCourse.number = courseData[rowNum][0];
-            newCourse.name = courseData[rowNum][1];
-
-            // Checks if the course has prerequisites
-            if (rowLength > 2) {
-                vector<string> currentPreReqs;
-
-                // Iterates through the remaining parameters in the row, starting at the third parameter
-                for (int paramNum = 2; paramNum < rowLength; paramNum++) {
-                    // Initializes a boolean to indicate if the preReq is a valid course
-                    bool isValid = false;
-
-                    // Loops all rows in the courseData vector
-                    for (int nestedRowNum = 0; nestedRowNum < courseFileSize; nestedRowNum++) {
-                        // Checks if the prerequisites has an associated course number in the file
-                        if (courseData[nestedRowNum][0] == courseData[rowNum][paramNum]) {
-                            // Sets the isValid boolean to true
-                            isValid = true;
-                            // Exits the for loop
-                            continue;
-                        }
-                    }
-
-                    // Checks if the isValid boolean is still false, if so an error is thrown
-                    if (!isValid) {
-                        //Credit: https://www.geeksforgeeks.org/cpp/stringstream-c-applications/
-                            // Utilize a string stream to combine strings and integers into a singular string
-
-                        // Initializes a string stream to house the error message
-                        stringstream errorMessage;
-                        // Inserts the error message to the string stream
-                        errorMessage << "File row #" << rowNum << " has prerequisites for non-listed courses!";
-                        // Converts the error message to an string and throws the error message
-                        throw std::runtime_error(errorMessage.str());
-                    }
-
-                    // Insert the pre prerequisites into the course object's preReqs vector
-                    newCourse.preReqs.push_back(courseData[rowNum][paramNum]);
+            // Iterates through the remaining parameters in the row, starting at the third parameter
+            for (int paramNum = 2; paramNum < rowLength; paramNum++) {
+                // Checks if the prerequisite has no associated course number in the file, if so an error is thrown
+                if (courseNumbers.count(row[paramNum]) == 0) {
+                    //Credit: https://www.geeksforgeeks.org/cpp/stringstream-c-applications/
+                        // Utilize a string stream to combine strings and integers into a singular string
+
+                    // Initializes a string stream to house the error message
+                    stringstream errorMessage;
+                    // Inserts the error message to the string stream
+                    errorMessage << "File row #" << rowNum << " has prerequisites for non-listed courses!";
+                    // Converts the error message to an string and throws the error message
+                    throw std::runtime_error(errorMessage.str());
                 }
             }
 
+            // Initializes a new course object and moves the number, name and prerequisites into it without copying
+            Course newCourse;
+            newCourse.number = std::move(row[0]);
+            newCourse.name = std::move(row[1]);
+            newCourse.preReqs.reserve(rowLength - 2);
+            for (int paramNum = 2; paramNum < rowLength; paramNum++) {
+                newCourse.preReqs.push_back(std::move(row[paramNum]));
+            }
+
             // Calls the Binary Tree's insert method to insert the new course
-            courses->Insert(newCourse);
+            courses->Insert(std::move(newCourse));
         }
     }
     catch (const std::runtime_error& e) {
@@ -446,8 +609,8 @@ bool loadCourseData(string csvFilePath, BinarySearchTree* courses) {
                     newCourseData.push_back(currentParameter);
                 }
             }
-            // Pushes the newCourseData vector to the courseData Vector
-            courseData.push_back(newCourseData);
+            // Moves the newCourseData vector into the courseData Vector
+            courseData.push_back(std::move(newCourseData));
         }
 
         // Closes the file after reading the data
@@ -475,6 +638,8 @@ int main()
 {
     // Initializes a pointer to a new binary search tree
     BinarySearchTree* courses = new BinarySearchTree();
+    // Initializes the graph of prerequisites between the loaded courses
+    PrerequisiteGraph prereqGraph;
     // Initializes two string vars to store the csv file path and the courseNumber entered by the user
     string csvPath;
     string courseNumber;
@@ -493,6 +658,9 @@ int main()
             "\n1. Load Course Data\n" <<
             "2. Display All Courses\n" <<
             "3. Display Course\n" <<
+            "4. Display All Prerequisites\n" <<
+            "5. Display Courses Unlocked\n" <<
+            "6. Check Course Requirement\n" <<
             "9. Exit\n\n" <<
             "What would you like to do? ";
         // Gathers the user's input
@@ -513,6 +681,20 @@ int main()
                 // Display a message to the user warning them of the failed loading
                 cout << "Failed to load data from file!" << endl;
             }
+            else {
+                // Builds the prerequisite graph from the loaded courses
+                prereqGraph.Build(courses);
+
+                // Warns the user if the prerequisites form a cycle, since those courses can never be taken
+                vector<string> cycle = prereqGraph.Cycle();
+                if (!cycle.empty()) {
+                    cout << "Warning: prerequisites form a cycle: ";
+                    for (size_t i = 0; i < cycle.size(); i++) {
+                        cout << (i > 0 ? " -> " : "") << cycle[i];
+                    }
+                    cout << endl;
+                }
+            }
             
             break;
         case 2: // Displays all courses in the binary search tree
@@ -544,6 +726,63 @@ int main()
                 cout << "Load data before displaying all courses!" << endl;
             }
             break;
+        case 4: // Displays every course required before a course
+        case 5: // Displays every course that requires a course
+            // Check if data is loaded
+            if (isDataLoaded) {
+                // Indicates the user needs to enter a course number
+                cout << "\nWhat course do you want to know about? ";
+                // Gathers the user's input
+                cin >> courseNumber;
+
+                // Looks up the course's transitive prerequisites or dependents
+                vector<string> related;
+                bool found = choice == 4
+                    ? prereqGraph.AllPrerequisites(courseNumber, related)
+                    : prereqGraph.Unlocks(courseNumber, related);
+
+                if (!found) {
+                    cout << "Associated course not found!" << endl;
+                }
+                else if (related.empty()) {
+                    cout << (choice == 4 ? "No prerequisites." : "No courses require it.") << endl;
+                }
+                else {
+                    cout << (choice == 4 ? "All prerequisites: " : "Courses unlocked: ");
+                    for (size_t i = 0; i < related.size(); i++) {
+                        cout << (i > 0 ? ", " : "") << related[i];
+                    }
+                    cout << endl;
+                }
+            }
+            else {
+                // Display a warning message to the user
+                cout << "Load data before displaying all courses!" << endl;
+            }
+            break;
+        case 6: // Checks if one course must be taken before another
+            // Check if data is loaded
+            if (isDataLoaded) {
+                // Gathers the later course and the course that may be required before it
+                string prereqNumber;
+                cout << "\nWhat course do you want to take? ";
+                cin >> courseNumber;
+                cout << "Which course might it require? ";
+                cin >> prereqNumber;
+
+                // Checks both courses exist, then answers from the transitive closure
+                if (!prereqGraph.Contains(courseNumber) || !prereqGraph.Contains(prereqNumber)) {
+                    cout << "Associated course not found!" << endl;
+                    break;
+                }
+                cout << courseKey(courseNumber) << (prereqGraph.Requires(courseNumber, prereqNumber) ? " requires " : " does not require ")
+                    << courseKey(prereqNumber) << endl;
+            }
+            else {
+                // Display a warning message to the user
+                cout << "Load data before displaying all courses!" << endl;
+            }
+            break;
         case 9: // Exits the statement
             // Exits the statement if the exit button is pressed
             break;
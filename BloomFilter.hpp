@@ -0,0 +1,168 @@
+//============================================================================
+// Name        : BloomFilter.hpp
+// Author      : Cristiano Miranda
+// Version     : 1.0
+// Description : Blocked Bloom filter shared by the bid hash table and trees
+//============================================================================
+
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// default number of ids a Bloom filter is sized for
+const size_t DEFAULT_BLOOM_CAPACITY = 1000;
+
+/**
+ * Define a class containing data members and methods to
+ * implement a blocked Bloom filter over bid ids.
+ *
+ * Each id maps to one 512-bit block, a single cache line, and sets a few
+ * bits inside it, so a membership test costs one memory access. A negative
+ * answer is always correct; a positive answer is wrong with roughly the
+ * configured false-positive rate. Ids cannot be removed, so removals only
+ * leave stale bits that show up as extra false positives.
+ */
+class BloomFilter {
+
+private:
+    // Define a structure for one cache-line sized block of bits
+    struct alignas(64) Block {
+        uint64_t words[8];
+    };
+
+    std::vector<Block> blocks;
+    unsigned int numHashes = 0;
+    size_t capacity = 0;
+    size_t count = 0;
+    double falsePositiveRate = 0.01;
+
+    static uint64_t hash(const std::string& bidId);
+
+public:
+    BloomFilter();
+    void Reset(size_t expectedCount, double rate);
+    void Add(const std::string& bidId);
+    bool MayContain(const std::string& bidId) const;
+    bool IsOverCapacity() const;
+    size_t Capacity() const;
+    double FalsePositiveRate() const;
+};
+
+/**
+ * Default constructor
+ */
+inline BloomFilter::BloomFilter() {
+    Reset(DEFAULT_BLOOM_CAPACITY, falsePositiveRate);
+}
+
+/**
+ * Clear the filter and size it for a number of ids and a false-positive rate
+ *
+ * @param expectedCount The number of ids the filter should hold
+ * @param rate The target false-positive rate, e.g. 0.01
+ */
+inline void BloomFilter::Reset(size_t expectedCount, double rate) {
+    // Clamps the rate to a usable range
+    falsePositiveRate = std::min(0.5, std::max(rate, 0.0001));
+    capacity = std::max<size_t>(expectedCount, 1);
+    count = 0;
+
+    // Uses the standard bits-per-id formula plus 20% to make up for blocking
+    double bitsPerId = -std::log(falsePositiveRate) / (std::log(2.0) * std::log(2.0)) * 1.2;
+    numHashes = static_cast<unsigned int>(std::min(16.0, std::max(1.0, std::round(bitsPerId / 1.2 * std::log(2.0)))));
+
+    size_t numBlocks = static_cast<size_t>(std::ceil(capacity * bitsPerId / 512.0));
+    blocks.assign(std::max<size_t>(numBlocks, 1), Block());
+}
+
+/**
+ * Calculate the filter's hash of a bid id (FNV-1a with a final mix)
+ * The basis is offset by a fixed seed so the hash stays independent of the
+ * unseeded hash tables use for their buckets.
+ *
+ * @param bidId The key to hash
+ */
+inline uint64_t BloomFilter::hash(const std::string& bidId) {
+    uint64_t h = 14695981039346656037ULL ^ 0x9e3779b97f4a7c15ULL;
+    for (unsigned char c : bidId) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+
+    // Mixes the low bits up into the high bits used for the bit positions
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * Add a bid id to the filter
+ *
+ * @param bidId The bid id to add
+ */
+inline void BloomFilter::Add(const std::string& bidId) {
+    uint64_t h = hash(bidId);
+    Block& block = blocks[(h >> 32) % blocks.size()];
+
+    // Derives each bit position from the hash by double hashing
+    uint64_t step = (h * 0xff51afd7ed558ccdULL) | 1;
+    for (unsigned int i = 0; i < numHashes; i++) {
+        unsigned int bit = static_cast<unsigned int>(h >> 55);
+        block.words[bit >> 6] |= 1ULL << (bit & 63);
+        h += step;
+    }
+
+    count++;
+}
+
+/**
+ * Test whether a bid id may have been added
+ *
+ * @param bidId The bid id to test
+ * @return False when the id was definitely never added
+ */
+inline bool BloomFilter::MayContain(const std::string& bidId) const {
+    uint64_t h = hash(bidId);
+    const Block& block = blocks[(h >> 32) % blocks.size()];
+
+    // Checks the same bit positions that Add sets
+    uint64_t step = (h * 0xff51afd7ed558ccdULL) | 1;
+    for (unsigned int i = 0; i < numHashes; i++) {
+        unsigned int bit = static_cast<unsigned int>(h >> 55);
+        if ((block.words[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+            return false;
+        }
+        h += step;
+    }
+
+    return true;
+}
+
+/**
+ * Returns true once more ids were added than the filter was sized for
+ */
+inline bool BloomFilter::IsOverCapacity() const {
+    return count > capacity;
+}
+
+/**
+ * Returns the number of ids the filter was sized for
+ */
+inline size_t BloomFilter::Capacity() const {
+    return capacity;
+}
+
+/**
+ * Returns the configured false-positive rate
+ */
+inline double BloomFilter::FalsePositiveRate() const {
+    return falsePositiveRate;
+}
+
+#endif // BLOOM_FILTER_HPP
@@ -0,0 +1,329 @@
+//============================================================================
+// Name        : OrderedMap.hpp
+// Author      : Cristiano Miranda
+// Version     : 1.0
+// Description : AVL-balanced ordered map shared by the bid and course trees
+//============================================================================
+
+#ifndef ORDERED_MAP_HPP
+#define ORDERED_MAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * Define a class template containing data members and methods to
+ * implement an ordered map as an AVL-balanced binary search tree.
+ *
+ * Keys are compared only through Compare, so the comparison is inlined for
+ * each instantiation: with an integer key and std::less it is a single
+ * instruction instead of a string compare. Keys are unique; inserting an
+ * existing key replaces its value. Lookups and traversals are iterative,
+ * and the recursion in Insert and Remove is bounded by the O(log n) height.
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class OrderedMap {
+
+private:
+    // Define a structure for the tree nodes
+    struct MapNode {
+        Key key;
+        Value value;
+        MapNode* left = nullptr;
+        MapNode* right = nullptr;
+        int height = 1;
+
+        MapNode(Key aKey, Value aValue) : key(std::move(aKey)), value(std::move(aValue)) {
+        }
+    };
+
+    MapNode* root = nullptr;
+    size_t size = 0;
+    Compare less;
+
+    static int height(MapNode* node);
+    static void updateHeight(MapNode* node);
+    static MapNode* rotateLeft(MapNode* node);
+    static MapNode* rotateRight(MapNode* node);
+    static MapNode* rebalance(MapNode* node);
+    MapNode* insertNode(MapNode* node, Key& key, Value& value);
+    MapNode* removeNode(MapNode* node, const Key& key, bool& removed);
+    static MapNode* removeMin(MapNode* node, MapNode*& minNode);
+
+public:
+    OrderedMap();
+    OrderedMap(const OrderedMap&) = delete;
+    OrderedMap& operator=(const OrderedMap&) = delete;
+    virtual ~OrderedMap();
+    void Clear();
+    void Insert(Key key, Value value);
+    bool Remove(const Key& key);
+    const Value* Find(const Key& key) const;
+    template <typename Visit> void ForEach(Visit visit) const;
+    size_t Size() const;
+    int Height() const;
+};
+
+/**
+ * Default constructor
+ */
+template <typename Key, typename Value, typename Compare>
+OrderedMap<Key, Value, Compare>::OrderedMap() {
+}
+
+/**
+ * Destructor
+ */
+template <typename Key, typename Value, typename Compare>
+OrderedMap<Key, Value, Compare>::~OrderedMap() {
+    Clear();
+}
+
+/**
+ * Free every node and leave the map empty
+ */
+template <typename Key, typename Value, typename Compare>
+void OrderedMap<Key, Value, Compare>::Clear() {
+    std::vector<MapNode*> pending;
+    if (root != nullptr) {
+        pending.push_back(root);
+    }
+    while (!pending.empty()) {
+        MapNode* node = pending.back();
+        pending.pop_back();
+        if (node->left != nullptr) {
+            pending.push_back(node->left);
+        }
+        if (node->right != nullptr) {
+            pending.push_back(node->right);
+        }
+        delete node;
+    }
+
+    root = nullptr;
+    size = 0;
+}
+
+/**
+ * Insert a value, replacing the value of an existing key
+ */
+template <typename Key, typename Value, typename Compare>
+void OrderedMap<Key, Value, Compare>::Insert(Key key, Value value) {
+    root = insertNode(root, key, value);
+}
+
+/**
+ * Remove a key
+ *
+ * @return True if the key was in the map
+ */
+template <typename Key, typename Value, typename Compare>
+bool OrderedMap<Key, Value, Compare>::Remove(const Key& key) {
+    bool removed = false;
+    root = removeNode(root, key, removed);
+    return removed;
+}
+
+/**
+ * Search for a key
+ *
+ * @return The key's value, or null if the key is not in the map
+ */
+template <typename Key, typename Value, typename Compare>
+const Value* OrderedMap<Key, Value, Compare>::Find(const Key& key) const {
+    MapNode* node = root;
+    while (node != nullptr) {
+        if (less(key, node->key)) {
+            node = node->left;
+        }
+        else if (less(node->key, key)) {
+            node = node->right;
+        }
+        else {
+            return &node->value;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Call visit(key, value) for every entry in key order
+ */
+template <typename Key, typename Value, typename Compare>
+template <typename Visit>
+void OrderedMap<Key, Value, Compare>::ForEach(Visit visit) const {
+    std::vector<MapNode*> pending;
+    MapNode* node = root;
+    while (node != nullptr || !pending.empty()) {
+        while (node != nullptr) {
+            pending.push_back(node);
+            node = node->left;
+        }
+        node = pending.back();
+        pending.pop_back();
+        visit(node->key, node->value);
+        node = node->right;
+    }
+}
+
+/**
+ * Returns the number of entries in the map
+ */
+template <typename Key, typename Value, typename Compare>
+size_t OrderedMap<Key, Value, Compare>::Size() const {
+    return size;
+}
+
+/**
+ * Returns the number of levels in the tree
+ */
+template <typename Key, typename Value, typename Compare>
+int OrderedMap<Key, Value, Compare>::Height() const {
+    return height(root);
+}
+
+/**
+ * Returns the height of a subtree, zero for an empty one
+ */
+template <typename Key, typename Value, typename Compare>
+int OrderedMap<Key, Value, Compare>::height(MapNode* node) {
+    return node == nullptr ? 0 : node->height;
+}
+
+/**
+ * Recalculate a node's height from its children's
+ */
+template <typename Key, typename Value, typename Compare>
+void OrderedMap<Key, Value, Compare>::updateHeight(MapNode* node) {
+    node->height = 1 + std::max(height(node->left), height(node->right));
+}
+
+/**
+ * Rotate a subtree left, lifting its right child into its place
+ */
+template <typename Key, typename Value, typename Compare>
+typename OrderedMap<Key, Value, Compare>::MapNode* OrderedMap<Key, Value, Compare>::rotateLeft(MapNode* node) {
+    MapNode* newRoot = node->right;
+    node->right = newRoot->left;
+    newRoot->left = node;
+    updateHeight(node);
+    updateHeight(newRoot);
+    return newRoot;
+}
+
+/**
+ * Rotate a subtree right, lifting its left child into its place
+ */
+template <typename Key, typename Value, typename Compare>
+typename OrderedMap<Key, Value, Compare>::MapNode* OrderedMap<Key, Value, Compare>::rotateRight(MapNode* node) {
+    MapNode* newRoot = node->left;
+    node->left = newRoot->right;
+    newRoot->right = node;
+    updateHeight(node);
+    updateHeight(newRoot);
+    return newRoot;
+}
+
+/**
+ * Restore the AVL property at a node whose children are already balanced
+ */
+template <typename Key, typename Value, typename Compare>
+typename OrderedMap<Key, Value, Compare>::MapNode* OrderedMap<Key, Value, Compare>::rebalance(MapNode* node) {
+    updateHeight(node);
+    int balance = height(node->left) - height(node->right);
+
+    if (balance > 1) {
+        if (height(node->left->left) < height(node->left->right)) {
+            node->left = rotateLeft(node->left);
+        }
+        return rotateRight(node);
+    }
+    if (balance < -1) {
+        if (height(node->right->right) < height(node->right->left)) {
+            node->right = rotateRight(node->right);
+        }
+        return rotateLeft(node);
+    }
+    return node;
+}
+
+/**
+ * Add an entry below some node and rebalance on the way back up (recursive)
+ */
+template <typename Key, typename Value, typename Compare>
+typename OrderedMap<Key, Value, Compare>::MapNode* OrderedMap<Key, Value, Compare>::insertNode(MapNode* node, Key& key, Value& value) {
+    if (node == nullptr) {
+        size++;
+        return new MapNode(std::move(key), std::move(value));
+    }
+
+    if (less(key, node->key)) {
+        node->left = insertNode(node->left, key, value);
+    }
+    else if (less(node->key, key)) {
+        node->right = insertNode(node->right, key, value);
+    }
+    else {
+        node->value = std::move(value);
+        return node;
+    }
+    return rebalance(node);
+}
+
+/**
+ * Unlink the smallest node of a subtree, rebalancing on the way back up (recursive)
+ *
+ * @param minNode Set to the unlinked node
+ * @return The new root of the subtree
+ */
+template <typename Key, typename Value, typename Compare>
+typename OrderedMap<Key, Value, Compare>::MapNode* OrderedMap<Key, Value, Compare>::removeMin(MapNode* node, MapNode*& minNode) {
+    if (node->left == nullptr) {
+        minNode = node;
+        return node->right;
+    }
+    node->left = removeMin(node->left, minNode);
+    return rebalance(node);
+}
+
+/**
+ * Remove a key from below some node and rebalance on the way back up (recursive)
+ * A node with two children is replaced by its successor node, which is
+ * relinked rather than copied, so values are never moved.
+ */
+template <typename Key, typename Value, typename Compare>
+typename OrderedMap<Key, Value, Compare>::MapNode* OrderedMap<Key, Value, Compare>::removeNode(MapNode* node, const Key& key, bool& removed) {
+    if (node == nullptr) {
+        return nullptr;
+    }
+
+    if (less(key, node->key)) {
+        node->left = removeNode(node->left, key, removed);
+    }
+    else if (less(node->key, key)) {
+        node->right = removeNode(node->right, key, removed);
+    }
+    else {
+        removed = true;
+        size--;
+        MapNode* left = node->left;
+        MapNode* right = node->right;
+        delete node;
+
+        if (left == nullptr || right == nullptr) {
+            return left != nullptr ? left : right;
+        }
+
+        // Lifts the successor into the removed node's place
+        MapNode* successor = nullptr;
+        MapNode* rest = removeMin(right, successor);
+        successor->left = left;
+        successor->right = rest;
+        return rebalance(successor);
+    }
+    return rebalance(node);
+}
+
+#endif // ORDERED_MAP_HPP